@@ -11,6 +11,26 @@
  *     3. IntrusiveOrderList push_back (the key optimization)
  *     4. PriceLevel add_order + match cycle
  *     5. Full pipeline: add → match → report (end-to-end)
+ *     6. Sharded matching: throughput vs. shard count (scaling efficiency)
+ *     7. Per-fill cost of the ExecutionReport stream (with vs. without sink)
+ *     8. Cross-thread pool: ObjectPool + mutex vs. ConcurrentObjectPool
+ *     9. Cancel-heavy flow at one price (90% cancels, deep queue)
+ *    10. Order ID index lookup at 1M / 10M live orders
+ *    11. Marketable limit orders: rest + match vs. cross-on-entry
+ *    12. Amend: REPLACE in place vs. CANCEL + new LIMIT
+ *    13. Session disconnect: MASS_CANCEL vs. one CANCEL per order
+ *    14. Trade cost with parked stops
+ *    15. Iceberg refill vs. client-side child orders
+ *    16. Call auction: equilibrium search and uncross
+ *    17. Matching policy: price-time vs. pro-rata
+ *    18. L2 level-delta feed cost (with vs. without feed)
+ *    19. Top-of-book seqlock: publish / read
+ *    20. Full-depth snapshot of a deep book
+ *    21. L3 order-by-order feed cost (with vs. without feed)
+ *    22. Conflated depth cache publish, with and without readers
+ *    23. Ring buffer ping-pong and streaming, single vs. bulk
+ *    24. One matcher fed by 1..16 gateway threads (MPSC ring)
+ *    25. Copying push/pop vs. in-place claim/peek, by payload size
  *
  *   Reports p50, p99, p99.9, min, max, and mean latencies in nanoseconds.
  *
@@ -27,8 +47,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <numeric>
+#include <thread>
 #include <vector>
 
 // ═══════════════════════════════════════════════════════════════════════
@@ -292,6 +315,1434 @@ void bench_full_pipeline(MemoryArena &arena) {
   bench::print_report("Full pipeline: add(bid) + add(ask) + match", report);
 }
 
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 6: Sharded throughput vs. shard count
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Runs N pinned MatcherThreads, each fed by its own producer replaying a
+/// pre-built limit-order flow (built off the clock from the shard's pool), so
+/// the measurement isolates the matchers rather than one gateway's RNG.
+/// Each shard's execution ring gets its own consumer so fills never stall.
+void bench_shard_scaling() {
+  constexpr std::size_t ORDERS_PER_SHARD = 200'000;
+  const std::size_t hw =
+      std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+  std::cout << "\n  ┌─ Sharded matching throughput (" << ORDERS_PER_SHARD
+            << " limit orders/shard, " << hw << " hw threads)\n";
+
+  double base_throughput = 0.0;
+
+  for (std::size_t n : {1, 2, 4, 8}) {
+    if (n > 1 && 3 * n > hw) {
+      std::cout << "  │  " << n << " shard(s):  skipped (needs " << 3 * n
+                << " hw threads)\n";
+      continue;
+    }
+
+    std::vector<std::unique_ptr<MatcherShard>> shards;
+    std::vector<std::vector<OrderMessage>> flows(n);
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> price_dist(0.0, 5000.0);
+    std::uniform_int_distribution<uint32_t> qty_dist(1, 1000);
+    uint64_t next_id = 1;
+
+    for (std::size_t i = 0; i < n; ++i) {
+      shards.push_back(std::make_unique<MatcherShard>(
+          ORDERS_PER_SHARD, config::MATCHER_CORE_ID + static_cast<int>(i)));
+      shards.back()->register_instruments(i, n, config::SIM_INSTRUMENT_COUNT);
+      ConcurrentObjectPool<Order>::Cache setup(shards.back()->pool);
+
+      flows[i].reserve(ORDERS_PER_SHARD);
+      for (std::size_t k = 0; k < ORDERS_PER_SHARD; ++k) {
+        Order *o = setup.acquire();
+        o->id = next_id++;
+        // k-th instrument owned by shard i under shard_of()
+        o->instrument_id = i + n * (k % (config::SIM_INSTRUMENT_COUNT / n));
+        o->price = config::MID_PRICE + static_cast<int64_t>(price_dist(rng));
+        o->price -= o->price % config::DEFAULT_TICK_SIZE;
+        o->side = (k & 1) ? Side::ASK : Side::BID;
+        o->type = OrderType::LIMIT;
+        o->quantity = qty_dist(rng);
+        o->remaining_qty = o->quantity;
+        o->active = 1;
+
+        OrderMessage msg{};
+        msg.type = OrderType::LIMIT;
+        msg.order = o;
+        flows[i].push_back(msg);
+      }
+    }
+
+    std::vector<std::unique_ptr<ExecutionConsumer>> consumers;
+    std::vector<std::thread> consumer_threads;
+    for (auto &shard : shards) {
+      consumers.push_back(std::make_unique<ExecutionConsumer>(
+          std::vector<LockFreeRingBuffer<ExecutionReport> *>{
+              &shard->executions}));
+      consumer_threads.emplace_back(std::ref(*consumers.back()));
+    }
+
+    std::vector<std::thread> matchers;
+    for (auto &shard : shards) {
+      matchers.emplace_back(std::ref(shard->matcher));
+    }
+
+    bench::Timer timer;
+    timer.begin();
+
+    std::vector<std::thread> feeders;
+    for (std::size_t i = 0; i < n; ++i) {
+      feeders.emplace_back([&, i] {
+        for (const auto &msg : flows[i]) {
+          while (!shards[i]->ring.push(msg)) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    for (auto &shard : shards) {
+      while (shard->stats.orders_processed.load(std::memory_order_relaxed) <
+             ORDERS_PER_SHARD) {
+        std::this_thread::yield();
+      }
+    }
+    uint64_t elapsed = timer.elapsed_ns();
+
+    for (auto &t : feeders)
+      t.join();
+    for (auto &shard : shards)
+      shard->stats.running.store(false, std::memory_order_release);
+    for (auto &t : matchers)
+      t.join();
+    for (auto &c : consumers)
+      c->stop();
+    for (auto &t : consumer_threads)
+      t.join();
+
+    double throughput = static_cast<double>(n * ORDERS_PER_SHARD) * 1e9 /
+                        static_cast<double>(std::max<uint64_t>(elapsed, 1));
+    if (n == 1)
+      base_throughput = throughput;
+    double efficiency = throughput / (static_cast<double>(n) * base_throughput);
+
+    char line[128];
+    std::snprintf(line, sizeof(line),
+                  "  │  %zu shard(s): %12.0f ops/s   scaling %5.1f%%\n", n,
+                  throughput, efficiency * 100.0);
+    std::cout << line;
+  }
+
+  std::cout << "  └──────────────────────────────\n";
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 7: Per-fill ExecutionReport cost
+// ═══════════════════════════════════════════════════════════════════════
+
+/// One taker sweeps FILLS resting makers (FILLS reports per match() call).
+/// Sample = match() time / FILLS. The ring is drained off the clock between
+/// sweeps, so this is the matcher-side cost only.
+void bench_execution_reports(MemoryArena &arena, bool with_sink) {
+  constexpr std::size_t N = 2'000;
+  constexpr uint32_t FILLS = 64;
+  ObjectPool<Order> pool(arena, N * (FILLS + 1) + 1000);
+  LockFreeRingBuffer<ExecutionReport> ring(arena);
+  std::atomic<uint64_t> stalls{0};
+  ExecutionSink sink(ring, stalls);
+
+  OrderBook book;
+  if (with_sink)
+    book.set_execution_sink(&sink);
+  std::vector<uint64_t> samples(N);
+  bench::Timer timer;
+  uint64_t next_id = 1;
+
+  auto make = [&](Side side, uint32_t qty) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->price = 1'000'000;
+    o->remaining_qty = qty;
+    o->side = side;
+    o->type = OrderType::LIMIT;
+    return o;
+  };
+
+  for (std::size_t i = 0; i < N; ++i) {
+    for (uint32_t k = 0; k < FILLS; ++k)
+      book.add_order(make(Side::ASK, 1));
+    book.add_order(make(Side::BID, FILLS));
+
+    timer.begin();
+    book.match();
+    samples[i] = timer.elapsed_ns() / FILLS;
+
+    ExecutionReport r{};
+    while (ring.pop(r)) {
+    }
+  }
+
+  auto report = bench::compute_stats(samples);
+  bench::print_report(with_sink ? "Per-fill match cost, ExecutionReport published"
+                                : "Per-fill match cost, no sink attached",
+                      report);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 8: Pool contention (producer acquires, consumer releases)
+// ═══════════════════════════════════════════════════════════════════════
+
+/// The gateway/matcher split in isolation: one thread acquires and hands
+/// each pointer over an SPSC ring, the other releases it. Result is
+/// wall-clock ns per object. ObjectPool is not thread-safe, so its
+/// cross-thread run takes a mutex on both sides, which is what a caller
+/// would otherwise have to add.
+void bench_pool_contention() {
+  constexpr std::size_t N = 1'000'000;
+  constexpr std::size_t SLOTS = 1 << 17;
+
+  std::cout << "\n  ┌─ Pool acquire/release (" << N << " objects)\n";
+
+  auto print = [](const char *name, uint64_t elapsed_ns) {
+    char line[128];
+    std::snprintf(line, sizeof(line), "  │  %-34s %8.1f ns/op\n", name,
+                  static_cast<double>(elapsed_ns) / N);
+    std::cout << line;
+  };
+
+  auto single_thread = [&](auto &&acquire, auto &&release) {
+    bench::Timer timer;
+    timer.begin();
+    for (std::size_t i = 0; i < N; ++i)
+      release(acquire());
+    return timer.elapsed_ns();
+  };
+
+  auto cross_thread = [&](MemoryArena &arena, auto &&acquire,
+                          auto &&release) {
+    LockFreeRingBuffer<Order *> handoff(arena);
+    bench::Timer timer;
+    timer.begin();
+    std::thread consumer([&] {
+      Order *o = nullptr;
+      for (std::size_t got = 0; got < N;) {
+        if (handoff.pop(o)) {
+          release(o);
+          ++got;
+        }
+      }
+    });
+    for (std::size_t i = 0; i < N; ++i) {
+      Order *o;
+      while (!(o = acquire()))
+        std::this_thread::yield(); // all in flight: wait for a return
+      while (!handoff.push(o))
+        std::this_thread::yield();
+    }
+    consumer.join();
+    return timer.elapsed_ns();
+  };
+
+  {
+    MemoryArena arena(32 * 1024 * 1024);
+    ObjectPool<Order> pool(arena, SLOTS);
+    print("ObjectPool, 1 thread",
+          single_thread([&] { return pool.acquire(); },
+                        [&](Order *o) { pool.release(o); }));
+
+    std::mutex lock;
+    print("ObjectPool + mutex, 2 threads",
+          cross_thread(
+              arena,
+              [&] {
+                std::lock_guard<std::mutex> guard(lock);
+                return pool.acquire();
+              },
+              [&](Order *o) {
+                std::lock_guard<std::mutex> guard(lock);
+                pool.release(o);
+              }));
+  }
+  {
+    MemoryArena arena(32 * 1024 * 1024);
+    ConcurrentObjectPool<Order> pool(arena, SLOTS);
+    ConcurrentObjectPool<Order>::Cache producer(pool);
+    ConcurrentObjectPool<Order>::Cache consumer(pool);
+    print("ConcurrentObjectPool, 1 thread",
+          single_thread([&] { return producer.acquire(); },
+                        [&](Order *o) { producer.release(o); }));
+    print("ConcurrentObjectPool, 2 threads",
+          cross_thread(
+              arena, [&] { return producer.acquire(); },
+              [&](Order *o) { consumer.release(o); }));
+  }
+
+  std::cout << "  └──────────────────────────────\n";
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 9: 90% cancel ratio at one price level
+// ═══════════════════════════════════════════════════════════════════════
+
+/// One price level kept DEPTH orders deep. Each step either cancels a
+/// random resting order (90%) or sends a 1-lot taker that fills the head
+/// (10%), then tops the level back up. Cancel and match are timed
+/// separately; with in-place unlinking neither depends on how many orders
+/// were cancelled before.
+void bench_cancel_heavy(MemoryArena &arena) {
+  constexpr std::size_t N = 200'000;
+  constexpr std::size_t DEPTH = 10'000;
+  ObjectPool<Order> pool(arena, DEPTH * 2);
+  LockFreeRingBuffer<ExecutionReport> fills(arena); // tells us who filled
+  std::atomic<uint64_t> stalls{0};
+  ExecutionSink sink(fills, stalls);
+  InstrumentDirectory dir(pool.capacity());
+  dir.set_execution_sink(&sink);
+  dir.add_instrument(0);
+  OrderBook &book = *dir.find(0);
+
+  std::mt19937_64 rng(7);
+  std::vector<uint64_t> resting;          // ids of live asks, any order
+  std::vector<std::size_t> slot(DEPTH + 2 * N + 1); // id -> index in resting
+  resting.reserve(DEPTH);
+  uint64_t next_id = 1;
+
+  auto forget = [&](std::size_t pick) {
+    resting[pick] = resting.back();
+    slot[resting[pick]] = pick;
+    resting.pop_back();
+  };
+
+  auto add = [&](Side side) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->price = 1'000'000;
+    o->remaining_qty = 1;
+    o->side = side;
+    o->type = OrderType::LIMIT;
+    book.add_order(o);
+    return o->id;
+  };
+  auto top_up = [&] {
+    while (resting.size() < DEPTH) {
+      slot[next_id] = resting.size();
+      resting.push_back(add(Side::ASK));
+    }
+  };
+  top_up();
+
+  std::vector<uint64_t> cancel_samples;
+  std::vector<uint64_t> match_samples;
+  cancel_samples.reserve(N);
+  match_samples.reserve(N / 5);
+  bench::Timer timer;
+
+  for (std::size_t i = 0; i < N; ++i) {
+    if (rng() % 10 != 0) {
+      std::size_t pick = rng() % resting.size();
+      uint64_t id = resting[pick];
+      forget(pick);
+
+      timer.begin();
+      dir.cancel_order(id);
+      cancel_samples.push_back(timer.elapsed_ns());
+    } else {
+      add(Side::BID);
+      timer.begin();
+      book.match();
+      match_samples.push_back(timer.elapsed_ns());
+
+      ExecutionReport r{};
+      while (fills.pop(r))
+        forget(slot[r.maker_order_id]);
+    }
+    top_up();
+    dir.reclaim(pool, config::RECLAIM_BATCH);
+  }
+
+  auto cancel_report = bench::compute_stats(cancel_samples);
+  bench::print_report("Cancel, 90% cancel flow (10K deep level)",
+                      cancel_report);
+  auto match_report = bench::compute_stats(match_samples);
+  bench::print_report("Match head, 90% cancel flow (10K deep level)",
+                      match_report);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 10: Order ID index lookup at scale
+// ═══════════════════════════════════════════════════════════════════════
+
+/// OrderIdMap sized for `live` orders and filled to that many random IDs,
+/// the worst case for a hash of gateway-assigned sequence numbers. Times
+/// lookups of random live IDs (hits) and of IDs never inserted (misses,
+/// the cancel-after-fill path). Orders live in a plain vector: only their
+/// addresses and IDs matter here.
+void bench_order_id_index(std::size_t live) {
+  constexpr std::size_t N = 1'000'000;
+  std::vector<Order> orders(live);
+  OrderIdMap ids(live);
+
+  std::mt19937_64 rng(42);
+  for (auto &order : orders) {
+    order.id = rng();
+    while (!ids.insert(&order)) // 64-bit collision: draw again
+      order.id = rng();
+  }
+
+  std::vector<uint64_t> hit_samples;
+  std::vector<uint64_t> miss_samples;
+  hit_samples.reserve(N);
+  miss_samples.reserve(N);
+  bench::Timer timer;
+  uint64_t found = 0;
+
+  for (std::size_t i = 0; i < N; ++i) {
+    uint64_t id = orders[rng() % live].id;
+    timer.begin();
+    found += ids.find(id) != nullptr;
+    hit_samples.push_back(timer.elapsed_ns());
+  }
+  for (std::size_t i = 0; i < N; ++i) {
+    uint64_t id = rng();
+    timer.begin();
+    found += ids.find(id) != nullptr;
+    miss_samples.push_back(timer.elapsed_ns());
+  }
+
+  char name[96];
+  auto hit_report = bench::compute_stats(hit_samples);
+  std::snprintf(name, sizeof(name), "ID lookup hit, %zuM live orders",
+                live / 1'000'000);
+  bench::print_report(name, hit_report);
+  auto miss_report = bench::compute_stats(miss_samples);
+  std::snprintf(name, sizeof(name), "ID lookup miss, %zuM live orders",
+                live / 1'000'000);
+  bench::print_report(name, miss_report);
+
+  char line[160];
+  std::snprintf(line, sizeof(line),
+                "  %zu slots (%.0f MB), load %.2f, max displacement %zu "
+                "(cap %zu), %llu hits\n",
+                ids.slot_count(),
+                static_cast<double>(ids.slot_count() * 16) / (1024 * 1024),
+                static_cast<double>(ids.size()) /
+                    static_cast<double>(ids.slot_count()),
+                ids.max_displacement(), config::ORDER_ID_MAX_PROBE,
+                static_cast<unsigned long long>(found));
+  std::cout << line;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 11: Marketable limit orders
+// ═══════════════════════════════════════════════════════════════════════
+
+/// A 1-lot bid at the best ask, against DEPTH resting 1-lot asks at one
+/// price; each consumed ask is replaced untimed. Compares resting the taker
+/// and matching afterwards (add_order + match, the old LIMIT path) with
+/// crossing on entry (submit_limit).
+void bench_marketable_limit(MemoryArena &arena, bool cross_on_entry) {
+  constexpr std::size_t N = 100'000;
+  constexpr std::size_t DEPTH = 1'000;
+  ObjectPool<Order> pool(arena, DEPTH * 2);
+  InstrumentDirectory dir(pool.capacity());
+  dir.add_instrument(0);
+  OrderBook &book = *dir.find(0);
+
+  uint64_t next_id = 1;
+  auto make = [&](Side side) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->price = 1'000'000;
+    o->remaining_qty = 1;
+    o->side = side;
+    o->type = OrderType::LIMIT;
+    return o;
+  };
+  for (std::size_t i = 0; i < DEPTH; ++i)
+    book.add_order(make(Side::ASK));
+
+  std::vector<uint64_t> samples;
+  samples.reserve(N);
+  bench::Timer timer;
+
+  for (std::size_t i = 0; i < N; ++i) {
+    Order *taker = make(Side::BID);
+    timer.begin();
+    if (cross_on_entry) {
+      book.submit_limit(taker);
+    } else {
+      book.add_order(taker);
+      book.match();
+    }
+    samples.push_back(timer.elapsed_ns());
+
+    book.add_order(make(Side::ASK));
+    dir.reclaim(pool, config::RECLAIM_BATCH);
+  }
+
+  auto report = bench::compute_stats(samples);
+  bench::print_report(cross_on_entry
+                          ? "Marketable limit, cross-on-entry (submit_limit)"
+                          : "Marketable limit, add_order + match",
+                      report);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 12: Amend (REPLACE vs. CANCEL + new LIMIT)
+// ═══════════════════════════════════════════════════════════════════════
+
+/// DEPTH resting bids spread over two adjacent ticks; each step moves a
+/// random one to the other tick with a new size, the market maker's
+/// bread-and-butter. REPLACE amends the resting Order; the old way cancels
+/// it and sends a fresh LIMIT (pool acquire, new ID, ID index insert).
+void bench_amend(MemoryArena &arena, bool in_place) {
+  constexpr std::size_t N = 200'000;
+  constexpr std::size_t DEPTH = 1'000;
+  ObjectPool<Order> pool(arena, DEPTH * 2);
+  InstrumentDirectory dir(pool.capacity());
+  dir.add_instrument(0);
+  OrderBook &book = *dir.find(0);
+
+  std::mt19937_64 rng(3);
+  std::vector<Order *> resting(DEPTH);
+  uint64_t next_id = 1;
+  auto make = [&](int64_t price, uint32_t qty) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->price = price;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = Side::BID;
+    o->type = OrderType::LIMIT;
+    return o;
+  };
+  for (std::size_t i = 0; i < DEPTH; ++i) {
+    resting[i] = make(990'000 + static_cast<int64_t>(i % 2) * 10, 100);
+    book.submit_limit(resting[i]);
+  }
+
+  std::vector<uint64_t> samples;
+  samples.reserve(N);
+  bench::Timer timer;
+
+  for (std::size_t i = 0; i < N; ++i) {
+    Order *&target = resting[rng() % DEPTH];
+    int64_t price = target->price == 990'000 ? 990'010 : 990'000;
+    auto qty = static_cast<uint32_t>(rng() % 100) + 1;
+
+    timer.begin();
+    if (in_place) {
+      dir.replace_order(target->id, price, qty);
+    } else {
+      dir.cancel_order(target->id);
+      target = make(price, qty);
+      book.submit_limit(target);
+    }
+    samples.push_back(timer.elapsed_ns());
+    dir.reclaim(pool, config::RECLAIM_BATCH);
+  }
+
+  auto report = bench::compute_stats(samples);
+  bench::print_report(in_place ? "Amend, REPLACE in place"
+                               : "Amend, CANCEL + new LIMIT",
+                      report);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 13: Session disconnect (MASS_CANCEL vs. one CANCEL per order)
+// ═══════════════════════════════════════════════════════════════════════
+
+/// OWNERS sessions rest DEPTH orders over INSTRUMENTS books, at random
+/// non-crossing prices. Each step disconnects a random session, times the
+/// pull of all its orders, then has it re-quote. The per-order baseline is
+/// what a gateway without MASS_CANCEL has to do: one cancel per known ID.
+/// One sample per disconnect (~DEPTH / OWNERS orders).
+void bench_mass_cancel(MemoryArena &arena, bool chained) {
+  constexpr std::size_t N = 2'000;
+  constexpr std::size_t DEPTH = 200'000;
+  constexpr std::size_t OWNERS = 64;
+  constexpr std::size_t INSTRUMENTS = 8;
+  ObjectPool<Order> pool(arena, DEPTH * 2);
+  InstrumentDirectory dir(pool.capacity());
+  dir.track_owners(pool);
+  for (uint64_t instrument = 0; instrument < INSTRUMENTS; ++instrument)
+    dir.add_instrument(instrument);
+
+  std::mt19937_64 rng(13);
+  std::vector<std::vector<uint64_t>> ids_of(OWNERS + 1);
+  uint64_t next_id = 1;
+  auto quote = [&](uint32_t owner) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->instrument_id = rng() % INSTRUMENTS;
+    o->owner_id = owner;
+    o->side = (rng() & 1) ? Side::BID : Side::ASK;
+    auto ticks = static_cast<int64_t>(rng() % 1'000) + 1;
+    o->price = config::MID_PRICE + (o->side == Side::BID ? -ticks : ticks) *
+                                       config::DEFAULT_TICK_SIZE;
+    o->quantity = 100;
+    o->remaining_qty = 100;
+    o->type = OrderType::LIMIT;
+    dir.submit_limit(*dir.find(o->instrument_id), o);
+    ids_of[owner].push_back(o->id);
+  };
+  for (std::size_t i = 0; i < DEPTH; ++i)
+    quote(static_cast<uint32_t>(i % OWNERS) + 1);
+
+  std::vector<uint64_t> samples;
+  samples.reserve(N);
+  bench::Timer timer;
+
+  for (std::size_t i = 0; i < N; ++i) {
+    auto owner = static_cast<uint32_t>(rng() % OWNERS) + 1;
+    std::size_t count = ids_of[owner].size();
+
+    timer.begin();
+    if (chained) {
+      dir.mass_cancel(owner);
+    } else {
+      for (uint64_t id : ids_of[owner])
+        dir.cancel_order(id);
+    }
+    samples.push_back(timer.elapsed_ns());
+
+    ids_of[owner].clear();
+    while (dir.reclaim(pool, config::RECLAIM_BATCH) > 0) {
+    }
+    for (std::size_t q = 0; q < count; ++q)
+      quote(owner);
+  }
+
+  auto report = bench::compute_stats(samples);
+  bench::print_report(chained ? "Disconnect, MASS_CANCEL (chain)"
+                              : "Disconnect, CANCEL per order",
+                      report);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 14: Trade cost with parked stops
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Benchmark 11's cross-on-entry loop with `parked` stops waiting on both
+/// sides, their triggers spread over 1'000 ticks just out of reach. Every
+/// fill checks the trigger index; none fires. Both runs size the pool and ID
+/// index for MAX_PARKED, so any gap between them is the cost of that check.
+void bench_stop_check(MemoryArena &arena, std::size_t parked) {
+  constexpr std::size_t N = 100'000;
+  constexpr std::size_t DEPTH = 1'000;
+  constexpr std::size_t MAX_PARKED = 100'000;
+  ObjectPool<Order> pool(arena, DEPTH * 2 + MAX_PARKED);
+  InstrumentDirectory dir(pool.capacity());
+  dir.add_instrument(0);
+  OrderBook &book = *dir.find(0);
+
+  uint64_t next_id = 1;
+  auto make = [&](Side side, OrderType type) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->price = 1'000'000;
+    o->remaining_qty = 1;
+    o->side = side;
+    o->type = type;
+    return o;
+  };
+  for (std::size_t i = 0; i < parked; ++i) {
+    auto ticks = static_cast<int64_t>(i / 2 % 1'000) + 1;
+    Side side = (i % 2) ? Side::BID : Side::ASK;
+    int64_t trigger = 1'000'000 + (side == Side::BID ? ticks : -ticks) *
+                                      config::DEFAULT_TICK_SIZE;
+    book.submit_stop(make(side, OrderType::STOP), trigger);
+  }
+  for (std::size_t i = 0; i < DEPTH; ++i)
+    book.add_order(make(Side::ASK, OrderType::LIMIT));
+
+  std::vector<uint64_t> samples;
+  samples.reserve(N);
+  bench::Timer timer;
+
+  for (std::size_t i = 0; i < N; ++i) {
+    Order *taker = make(Side::BID, OrderType::LIMIT);
+    timer.begin();
+    book.submit_limit(taker);
+    samples.push_back(timer.elapsed_ns());
+
+    book.add_order(make(Side::ASK, OrderType::LIMIT));
+    dir.reclaim(pool, config::RECLAIM_BATCH);
+  }
+
+  auto report = bench::compute_stats(samples);
+  bench::print_report(parked ? "Marketable limit, 100K stops parked"
+                             : "Marketable limit, no stops parked",
+                      report);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 15: Iceberg refill vs. client-side child orders
+// ═══════════════════════════════════════════════════════════════════════
+
+/// One seller works a large order showing PEAK lots at a time against a
+/// stream of PEAK-lot market buys. As an iceberg the book refills the next
+/// slice itself inside the level; without icebergs the client sends a new
+/// child LIMIT after each fill (pool acquire, new ID, ID index insert,
+/// level append), counted here with the fill that prompted it.
+void bench_iceberg(MemoryArena &arena, bool iceberg) {
+  constexpr std::size_t N = 200'000;
+  constexpr uint32_t PEAK = 10;
+  ObjectPool<Order> pool(arena, 1'024);
+  InstrumentDirectory dir(pool.capacity());
+  dir.add_instrument(0);
+  OrderBook &book = *dir.find(0);
+
+  uint64_t next_id = 1;
+  auto make = [&](Side side, OrderType type, uint32_t qty) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->price = 1'000'000;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    o->type = type;
+    return o;
+  };
+  if (iceberg) {
+    Order *parent = make(Side::ASK, OrderType::LIMIT, PEAK * N);
+    parent->peak_qty = PEAK;
+    book.submit_limit(parent);
+  } else {
+    book.submit_limit(make(Side::ASK, OrderType::LIMIT, PEAK));
+  }
+
+  std::vector<uint64_t> samples;
+  samples.reserve(N);
+  bench::Timer timer;
+
+  for (std::size_t i = 0; i < N; ++i) {
+    Order *taker = make(Side::BID, OrderType::MARKET, PEAK);
+    timer.begin();
+    book.match_market(taker);
+    if (!iceberg && i + 1 < N)
+      book.submit_limit(make(Side::ASK, OrderType::LIMIT, PEAK));
+    samples.push_back(timer.elapsed_ns());
+    pool.release(taker); // market orders never rest
+    dir.reclaim(pool, config::RECLAIM_BATCH);
+  }
+
+  auto report = bench::compute_stats(samples);
+  bench::print_report(iceberg ? "Working order, iceberg refill"
+                              : "Working order, child LIMIT per slice",
+                      report);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 16: Call auction (equilibrium search and uncross)
+// ═══════════════════════════════════════════════════════════════════════
+
+/// A call auction crossed over the whole price window: every tick holds a
+/// bid and an ask of random size, so the search spans PRICE_WINDOW_LEVELS
+/// ticks. Times the equilibrium kernel alone, scalar and SSE2, then a full
+/// uncross(): gather, search and every fill at the auction price.
+void bench_call_auction() {
+  constexpr std::size_t N = 2'000;
+  constexpr std::size_t UNCROSSES = 200;
+  constexpr std::size_t TICKS = config::PRICE_WINDOW_LEVELS;
+  std::mt19937_64 rng(16);
+
+  std::vector<double> bids(TICKS), asks(TICKS), demand, supply;
+  for (std::size_t i = 0; i < TICKS; ++i) {
+    bids[i] = static_cast<double>(rng() % 100 + 1);
+    asks[i] = static_cast<double>(rng() % 100 + 1);
+  }
+  bench::Timer timer;
+  std::size_t equilibrium = 0;
+  for (bool simd : {false, true}) {
+    std::vector<uint64_t> samples;
+    samples.reserve(N);
+    for (std::size_t i = 0; i < N; ++i) {
+      demand = bids; // the search overwrites both curves
+      supply = asks;
+      timer.begin();
+      auto eq = simd ? auction::find_equilibrium(demand.data(), supply.data(),
+                                                 TICKS, TICKS / 2)
+                     : auction::find_equilibrium_scalar(
+                           demand.data(), supply.data(), TICKS, TICKS / 2);
+      samples.push_back(timer.elapsed_ns());
+      equilibrium = eq.index;
+    }
+    auto report = bench::compute_stats(samples);
+    bench::print_report(simd ? "Auction search, 4096 ticks (SSE2)"
+                             : "Auction search, 4096 ticks (scalar)",
+                        report);
+  }
+
+  std::vector<Order> orders(TICKS * 2);
+  std::vector<uint64_t> samples;
+  samples.reserve(UNCROSSES);
+  uint64_t filled = 0;
+  for (std::size_t u = 0; u < UNCROSSES; ++u) {
+    OrderIdMap ids(orders.size());
+    OrderBook book(&ids);
+    book.begin_auction();
+    int64_t tick = book.window_low_price();
+    for (std::size_t i = 0; i < TICKS;
+         ++i, tick += config::DEFAULT_TICK_SIZE) {
+      for (Side side : {Side::BID, Side::ASK}) {
+        Order &o = orders[i * 2 + (side == Side::ASK)];
+        o = Order{};
+        o.id = i * 2 + (side == Side::ASK) + 1;
+        o.price = tick;
+        o.remaining_qty = static_cast<uint32_t>(rng() % 100 + 1);
+        o.quantity = o.remaining_qty;
+        o.side = side;
+        book.submit_limit(&o);
+      }
+    }
+    timer.begin();
+    filled += book.uncross();
+    samples.push_back(timer.elapsed_ns());
+  }
+  auto report = bench::compute_stats(samples);
+  bench::print_report("Uncross, 4096 crossed ticks per side", report);
+  char line[160];
+  std::snprintf(line, sizeof(line),
+                "  search equilibrium at tick %zu of %zu, %llu lots per "
+                "uncross\n",
+                equilibrium, TICKS,
+                static_cast<unsigned long long>(filled / UNCROSSES));
+  std::cout << line;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 17: Matching policy (price-time vs. pro-rata)
+// ═══════════════════════════════════════════════════════════════════════
+
+/// A taker for a fifth of a level of MAKERS equal orders. Price-time fills
+/// the oldest MAKERS / 5; pro-rata fills the top order, then gives every
+/// maker its share. The level is rebuilt between samples, off the clock.
+template <MatchingPolicy Policy>
+void bench_matching_policy(MemoryArena &arena, const char *name) {
+  constexpr std::size_t N = 20'000;
+  constexpr std::size_t MAKERS = 100;
+  constexpr uint32_t SIZE = 100;
+  ObjectPool<Order> pool(arena, MAKERS + 1);
+  OrderIdMap ids(pool.capacity());
+  IntrusiveOrderList graveyard;
+  BasicOrderBook<Policy> book(&ids);
+  book.set_graveyard(&graveyard);
+
+  uint64_t next_id = 1;
+  auto make = [&](Side side, uint32_t qty) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->price = 1'000'000;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    o->type = OrderType::LIMIT;
+    return o;
+  };
+
+  std::vector<uint64_t> samples;
+  samples.reserve(N);
+  bench::Timer timer;
+  uint64_t fills = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    uint64_t first_maker = next_id;
+    for (std::size_t m = 0; m < MAKERS; ++m)
+      book.add_order(make(Side::ASK, SIZE));
+    Order *taker = make(Side::BID, MAKERS * SIZE / 5);
+    uint64_t matches = book.match_count();
+
+    timer.begin();
+    book.submit_limit(taker);
+    samples.push_back(timer.elapsed_ns());
+    fills += book.match_count() - matches;
+
+    for (uint64_t id = first_maker; id < first_maker + MAKERS; ++id)
+      book.cancel_order(id);
+    while (Order *dead = graveyard.pop_front()) {
+      ids.erase(dead->id);
+      pool.release(dead);
+    }
+  }
+
+  auto report = bench::compute_stats(samples);
+  bench::print_report(name, report);
+  std::cout << "  " << fills / N << " fills per taker\n";
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 18: L2 level-delta feed cost
+// ═══════════════════════════════════════════════════════════════════════
+
+/// One message = a buy limit taking MAKERS resting asks spread over two
+/// levels, plus the flush that ends the message (one delta per level, not
+/// per fill). Sample = submit_limit() + flush(); the ring is drained off
+/// the clock.
+void bench_market_data(MemoryArena &arena, bool with_feed) {
+  constexpr std::size_t N = 20'000;
+  constexpr std::size_t MAKERS = 16;
+  ObjectPool<Order> pool(arena, MAKERS + 1);
+  OrderIdMap ids(pool.capacity());
+  IntrusiveOrderList graveyard;
+  LockFreeRingBuffer<LevelDelta> ring(arena);
+  std::atomic<uint64_t> drops{0};
+  MarketDataSink feed(ring, drops);
+  OrderBook book(&ids);
+  book.set_graveyard(&graveyard);
+  if (with_feed)
+    book.set_market_data_sink(&feed, 1);
+
+  uint64_t next_id = 1;
+  auto make = [&](Side side, int64_t price, uint32_t qty) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->price = price;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    o->type = OrderType::LIMIT;
+    return o;
+  };
+
+  std::vector<uint64_t> samples;
+  samples.reserve(N);
+  bench::Timer timer;
+  uint64_t deltas = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t m = 0; m < MAKERS; ++m)
+      book.add_order(make(Side::ASK, 1'000'000 + 10 * (m % 2), 10));
+    feed.flush();
+    LevelDelta d{};
+    while (ring.pop(d)) {
+    }
+    Order *taker = make(Side::BID, 1'000'010, MAKERS * 10);
+
+    uint64_t before = feed.sequence();
+    timer.begin();
+    book.submit_limit(taker);
+    feed.flush();
+    samples.push_back(timer.elapsed_ns());
+    deltas += feed.sequence() - before;
+
+    while (ring.pop(d)) {
+    }
+    while (Order *dead = graveyard.pop_front()) {
+      ids.erase(dead->id);
+      pool.release(dead);
+    }
+  }
+
+  auto report = bench::compute_stats(samples);
+  bench::print_report(with_feed ? "16-fill sweep + flush, L2 feed attached"
+                                : "16-fill sweep, no L2 feed",
+                      report);
+  char line[160];
+  std::snprintf(line, sizeof(line), "  %.1f deltas per message, %llu dropped\n",
+                static_cast<double>(deltas) / N,
+                static_cast<unsigned long long>(drops.load()));
+  std::cout << line;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 19: Top-of-book seqlock (publish / read)
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Writer and reader cost of one L1 cell, uncontended: what the matcher
+/// pays per top-of-book change, and what a risk or UI thread pays per poll.
+void bench_top_of_book() {
+  constexpr std::size_t N = 100'000;
+  TopOfBookCell cell;
+  std::vector<uint64_t> samples(N);
+  bench::Timer timer;
+
+  TopOfBook top;
+  for (std::size_t i = 0; i < N; ++i) {
+    top.bid_price = static_cast<int64_t>(i);
+    top.bid_qty = static_cast<uint32_t>(i);
+    timer.begin();
+    cell.publish(top);
+    samples[i] = timer.elapsed_ns();
+  }
+  bench::print_report("TopOfBookCell publish (matcher)",
+                      bench::compute_stats(samples));
+
+  uint64_t sequences = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    timer.begin();
+    TopOfBook seen = cell.read();
+    samples[i] = timer.elapsed_ns();
+    sequences += seen.sequence;
+  }
+  bench::print_report("TopOfBookCell read (any thread)",
+                      bench::compute_stats(samples));
+  char line[160];
+  std::snprintf(line, sizeof(line), "  %llu updates seen per read\n",
+                static_cast<unsigned long long>(sequences / N));
+  std::cout << line;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 20: Full-depth snapshot of a deep book
+// ═══════════════════════════════════════════════════════════════════════
+
+/// DEPTH occupied ticks per side, one order each; sample = one snapshot()
+/// of both sides into a reused BookSnapshot.
+void bench_snapshot(MemoryArena &arena) {
+  constexpr std::size_t N = 10'000;
+  constexpr std::size_t DEPTH = 1'500;
+  ObjectPool<Order> pool(arena, 2 * DEPTH);
+  OrderBook book;
+
+  uint64_t next_id = 1;
+  for (std::size_t i = 0; i < DEPTH; ++i) {
+    for (Side side : {Side::BID, Side::ASK}) {
+      Order *o = pool.acquire();
+      o->id = next_id++;
+      o->price = side == Side::BID ? 999'990 - 10 * static_cast<int64_t>(i)
+                                   : 1'000'000 + 10 * static_cast<int64_t>(i);
+      o->remaining_qty = 1 + static_cast<uint32_t>(i % 7);
+      o->side = side;
+      o->type = OrderType::LIMIT;
+      book.add_order(o);
+    }
+  }
+
+  auto snap = std::make_unique<BookSnapshot>();
+  std::vector<uint64_t> samples(N);
+  bench::Timer timer;
+  for (std::size_t i = 0; i < N; ++i) {
+    timer.begin();
+    book.snapshot(*snap);
+    samples[i] = timer.elapsed_ns();
+  }
+
+  auto report = bench::compute_stats(samples);
+  bench::print_report("Full-depth snapshot, 2 x 1500 levels", report);
+  char line[160];
+  std::snprintf(line, sizeof(line), "  %zu bid + %zu ask ticks per image\n",
+                snap->bids.levels, snap->asks.levels);
+  std::cout << line;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 21: L3 order-by-order feed cost
+// ═══════════════════════════════════════════════════════════════════════
+
+/// A round of MAKERS + 1 messages: MAKERS resting asks over two levels, then
+/// one buy limit taking them all. Every message emits its OrderEvents
+/// straight into the ring (ADD per maker, EXECUTE per fill). Sample = the
+/// whole round divided by its message count; the ring is drained off the
+/// clock.
+void bench_order_feed(MemoryArena &arena, bool with_feed) {
+  constexpr std::size_t N = 20'000;
+  constexpr std::size_t MAKERS = 16;
+  ObjectPool<Order> pool(arena, MAKERS + 1);
+  OrderIdMap ids(pool.capacity());
+  IntrusiveOrderList graveyard;
+  LockFreeRingBuffer<OrderEvent> ring(arena);
+  std::atomic<uint64_t> drops{0};
+  OrderFeedSink feed(ring, drops);
+  OrderBook book(&ids);
+  book.set_graveyard(&graveyard);
+  if (with_feed)
+    book.set_order_feed_sink(&feed);
+
+  uint64_t next_id = 1;
+  auto make = [&](Side side, int64_t price, uint32_t qty) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->price = price;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    o->type = OrderType::LIMIT;
+    return o;
+  };
+
+  std::array<Order *, MAKERS> makers{};
+  std::vector<uint64_t> samples;
+  samples.reserve(N);
+  bench::Timer timer;
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t m = 0; m < MAKERS; ++m)
+      makers[m] = make(Side::ASK, 1'000'000 + 10 * (m % 2), 10);
+    Order *taker = make(Side::BID, 1'000'010, MAKERS * 10);
+
+    timer.begin();
+    for (Order *maker : makers)
+      book.add_order(maker);
+    book.submit_limit(taker);
+    samples.push_back(timer.elapsed_ns() / (MAKERS + 1));
+
+    OrderEvent e{};
+    while (ring.pop(e)) {
+    }
+    while (Order *dead = graveyard.pop_front()) {
+      ids.erase(dead->id);
+      pool.release(dead);
+    }
+  }
+
+  auto report = bench::compute_stats(samples);
+  bench::print_report(with_feed ? "Per message, L3 feed attached"
+                                : "Per message, no L3 feed",
+                      report);
+  char line[160];
+  std::snprintf(line, sizeof(line), "  %.2f events per message, %llu dropped\n",
+                static_cast<double>(feed.sequence()) / (N * (MAKERS + 1)),
+                static_cast<unsigned long long>(drops.load()));
+  std::cout << line;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 22: Conflated depth cache publish, with and without readers
+// ═══════════════════════════════════════════════════════════════════════
+
+/// A book LEVELS deep on each side with a DepthCacheCell attached. Off the
+/// clock an order joins or leaves the best bid; sample = the publish_depth()
+/// that follows (gather the best levels, seqlock write). `readers` threads
+/// poll the cell nonstop meanwhile: the writer's cost should not move.
+void bench_depth_cache(MemoryArena &arena, std::size_t readers) {
+  constexpr std::size_t N = 100'000;
+  constexpr std::size_t LEVELS = 20;
+  ObjectPool<Order> pool(arena, 2 * LEVELS + 1);
+  OrderBook book;
+  DepthCacheCell cell;
+  book.set_depth_cache(&cell);
+
+  uint64_t next_id = 1;
+  auto make = [&](Side side, int64_t price) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->price = price;
+    o->remaining_qty = 5;
+    o->side = side;
+    o->type = OrderType::LIMIT;
+    return o;
+  };
+  for (std::size_t i = 0; i < LEVELS; ++i) {
+    book.add_order(make(Side::BID, 999'990 - 10 * static_cast<int64_t>(i)));
+    book.add_order(make(Side::ASK, 1'000'000 + 10 * static_cast<int64_t>(i)));
+  }
+  book.publish_depth(0);
+
+  std::atomic<bool> running{true};
+  std::vector<std::thread> threads;
+  std::atomic<uint64_t> reads{0};
+  for (std::size_t r = 0; r < readers; ++r) {
+    threads.emplace_back([&] {
+      uint64_t n = 0;
+      while (running.load(std::memory_order_relaxed)) {
+        ConflatedDepth depth = cell.read();
+        n += depth.sequence > 0;
+      }
+      reads.fetch_add(n, std::memory_order_relaxed);
+    });
+  }
+
+  Order *extra = make(Side::BID, 999'990);
+  std::vector<uint64_t> samples;
+  samples.reserve(N);
+  bench::Timer timer;
+  for (std::size_t i = 0; i < N; ++i) {
+    if (i % 2 == 0) {
+      extra->remaining_qty = 5;
+      extra->active = 1;
+      book.add_order(extra);
+    } else {
+      book.cancel(extra);
+    }
+    timer.begin();
+    book.publish_depth(i);
+    samples.push_back(timer.elapsed_ns());
+  }
+  running.store(false, std::memory_order_relaxed);
+  for (auto &t : threads)
+    t.join();
+
+  char name[96];
+  std::snprintf(name, sizeof(name),
+                "Depth cache publish, %zu levels/side, %zu reader(s)",
+                config::CONFLATED_DEPTH, readers);
+  bench::print_report(name, bench::compute_stats(samples));
+  char line[160];
+  std::snprintf(line, sizeof(line), "  %llu updates published, %llu reads\n",
+                static_cast<unsigned long long>(cell.read().sequence),
+                static_cast<unsigned long long>(reads.load()));
+  std::cout << line;
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 23: Ring buffer ping-pong and streaming, single vs bulk
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Two threads over LockFreeRingBuffer<OrderMessage>.
+///   - Ping-pong: one message goes out on one ring and comes back on
+///   another; reported per round trip. Nothing to batch, and each side
+///   re-reads the other's index every time (the ring always looks empty)
+///   - Streaming: N messages one way, one at a time or in batches of BATCH
+///   with push_bulk()/pop_bulk(); reported per message. Index lines move
+///   between cores once per batch instead of once per message
+void bench_ring_transfer() {
+  constexpr std::size_t ROUND_TRIPS = 200'000;
+  constexpr std::size_t N = 4'000'000;
+  constexpr std::size_t BATCH = 32;
+
+  std::cout << "\n  ┌─ Ring buffer across two threads\n";
+  auto print = [](const char *name, uint64_t elapsed_ns, std::size_t ops) {
+    char line[128];
+    std::snprintf(line, sizeof(line), "  │  %-34s %8.1f ns/op\n", name,
+                  static_cast<double>(elapsed_ns) / ops);
+    std::cout << line;
+  };
+
+  {
+    MemoryArena arena(2 * config::RING_BUFFER_CAPACITY * sizeof(OrderMessage) +
+                      4096);
+    LockFreeRingBuffer<OrderMessage> ping(arena);
+    LockFreeRingBuffer<OrderMessage> pong(arena);
+    std::thread echo([&] {
+      OrderMessage msg{};
+      for (std::size_t i = 0; i < ROUND_TRIPS; ++i) {
+        while (!ping.pop(msg))
+          std::this_thread::yield();
+        while (!pong.push(msg))
+          std::this_thread::yield();
+      }
+    });
+    bench::Timer timer;
+    timer.begin();
+    OrderMessage msg{};
+    for (std::size_t i = 0; i < ROUND_TRIPS; ++i) {
+      msg.target_id = i;
+      while (!ping.push(msg))
+        std::this_thread::yield();
+      while (!pong.pop(msg))
+        std::this_thread::yield();
+    }
+    print("Ping-pong round trip", timer.elapsed_ns(), ROUND_TRIPS);
+    echo.join();
+  }
+
+  for (bool bulk : {false, true}) {
+    MemoryArena arena(config::RING_BUFFER_CAPACITY * sizeof(OrderMessage) +
+                      4096);
+    LockFreeRingBuffer<OrderMessage> ring(arena);
+    uint64_t checksum = 0;
+    bench::Timer timer;
+    timer.begin();
+    std::thread consumer([&] {
+      std::array<OrderMessage, BATCH> out{};
+      for (std::size_t got = 0; got < N;) {
+        std::size_t n = bulk ? ring.pop_bulk(out.data(), BATCH)
+                             : static_cast<std::size_t>(ring.pop(out[0]));
+        if (n == 0)
+          std::this_thread::yield();
+        for (std::size_t i = 0; i < n; ++i)
+          checksum += out[i].target_id;
+        got += n;
+      }
+    });
+    std::array<OrderMessage, BATCH> in{};
+    for (std::size_t sent = 0; sent < N;) {
+      std::size_t want = std::min(BATCH, N - sent);
+      for (std::size_t i = 0; i < want; ++i)
+        in[i].target_id = sent + i;
+      std::size_t n = bulk ? ring.push_bulk(in.data(), want)
+                           : static_cast<std::size_t>(ring.push(in[0]));
+      if (n == 0)
+        std::this_thread::yield();
+      sent += n;
+    }
+    consumer.join();
+    print(bulk ? "Streaming, push_bulk/pop_bulk x32" : "Streaming, push/pop",
+          timer.elapsed_ns(), N);
+    if (checksum != N * (N - 1) / 2)
+      std::cout << "  │  [!!] stream lost or reordered messages\n";
+  }
+  std::cout << "  └──────────────────────────────\n";
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 24: One matcher fed by 1..16 gateway threads (MPSC ring)
+// ═══════════════════════════════════════════════════════════════════════
+
+/// One pinned MatcherThread drains its MPSC ring while n producers replay
+/// pre-built limit-order flows (disjoint IDs, TOTAL orders split evenly),
+/// released together off the clock. Reports the matcher's throughput, each
+/// producer's mean push cost (CAS retries and full-ring back-off included)
+/// and how often a push found the ring full. Producers beyond the hardware
+/// threads time-share cores, which is part of what is being measured.
+void bench_gateway_scaling() {
+  constexpr std::size_t TOTAL = 200'000;
+  const std::size_t hw =
+      std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+  std::cout << "\n  ┌─ Gateways into one matcher (" << TOTAL
+            << " limit orders, " << hw << " hw threads)\n";
+
+  for (std::size_t n : {1, 2, 4, 8, 16}) {
+    MatcherShard shard(TOTAL, config::MATCHER_CORE_ID);
+    shard.register_instruments(0, 1, config::SIM_INSTRUMENT_COUNT);
+
+    std::vector<std::vector<OrderMessage>> flows(n);
+    {
+      ConcurrentObjectPool<Order>::Cache setup(shard.pool);
+      std::mt19937_64 rng(42);
+      std::normal_distribution<double> price_dist(0.0, 5000.0);
+      std::uniform_int_distribution<uint32_t> qty_dist(1, 1000);
+      for (uint64_t id = 1; id <= TOTAL; ++id) {
+        Order *o = setup.acquire();
+        o->id = id;
+        o->instrument_id = id % config::SIM_INSTRUMENT_COUNT;
+        o->price = config::MID_PRICE + static_cast<int64_t>(price_dist(rng));
+        o->price -= o->price % config::DEFAULT_TICK_SIZE;
+        o->side = (id & 1) ? Side::ASK : Side::BID;
+        o->type = OrderType::LIMIT;
+        o->quantity = qty_dist(rng);
+        o->remaining_qty = o->quantity;
+        o->active = 1;
+
+        OrderMessage msg{};
+        msg.type = OrderType::LIMIT;
+        msg.order = o;
+        flows[id % n].push_back(msg);
+      }
+    }
+
+    ExecutionConsumer consumer(
+        std::vector<LockFreeRingBuffer<ExecutionReport> *>{&shard.executions});
+    std::thread consumer_thread(std::ref(consumer));
+    std::thread matcher(std::ref(shard.matcher));
+
+    std::atomic<bool> go{false};
+    std::vector<uint64_t> push_ns(n, 0);
+    std::vector<uint64_t> full(n, 0);
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < n; ++p) {
+      producers.emplace_back([&, p] {
+        while (!go.load(std::memory_order_acquire))
+          std::this_thread::yield();
+        bench::Timer timer;
+        timer.begin();
+        uint64_t retries = 0;
+        for (const auto &msg : flows[p]) {
+          while (!shard.ring.push(msg)) {
+            ++retries;
+            std::this_thread::yield();
+          }
+        }
+        push_ns[p] = timer.elapsed_ns();
+        full[p] = retries;
+      });
+    }
+
+    bench::Timer timer;
+    timer.begin();
+    go.store(true, std::memory_order_release);
+    while (shard.stats.orders_processed.load(std::memory_order_relaxed) <
+           TOTAL) {
+      std::this_thread::yield();
+    }
+    uint64_t elapsed = timer.elapsed_ns();
+
+    for (auto &t : producers)
+      t.join();
+    shard.stats.running.store(false, std::memory_order_release);
+    matcher.join();
+    consumer.stop();
+    consumer_thread.join();
+
+    double throughput = static_cast<double>(TOTAL) * 1e9 /
+                        static_cast<double>(std::max<uint64_t>(elapsed, 1));
+    double mean_push_ns = 0.0;
+    uint64_t full_total = 0;
+    for (std::size_t p = 0; p < n; ++p) {
+      mean_push_ns += static_cast<double>(push_ns[p]) /
+                      static_cast<double>(flows[p].size()) /
+                      static_cast<double>(n);
+      full_total += full[p];
+    }
+
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "  │  %2zu gateway(s): %10.0f ops/s  push %7.1f ns  "
+                  "full %5.2f%%\n",
+                  n, throughput, mean_push_ns,
+                  100.0 * static_cast<double>(full_total) / TOTAL);
+    std::cout << line;
+  }
+
+  std::cout << "  └──────────────────────────────\n";
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  Benchmark 25: Copying push/pop vs. in-place claim/peek, by payload size
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Streams N messages of `Bytes` bytes over the inbound MPSC ring between
+/// two threads, once through push()/pop() (build on the stack, copy in,
+/// copy out) and once through try_claim()/commit() and peek()/release()
+/// (built and read in the slot). Reported per message.
+template <std::size_t Bytes> void bench_zero_copy() {
+  constexpr std::size_t N = 2'000'000;
+  struct Message {
+    uint64_t words[Bytes / sizeof(uint64_t)];
+  };
+
+  for (bool in_place : {false, true}) {
+    MemoryArena arena(MpscRingBuffer<Message>::arena_bytes());
+    MpscRingBuffer<Message> ring(arena);
+    uint64_t checksum = 0;
+    bench::Timer timer;
+    timer.begin();
+    std::thread consumer([&] {
+      Message out;
+      for (std::size_t got = 0; got < N; ++got) {
+        if (in_place) {
+          const Message *msg;
+          while (!(msg = ring.peek()))
+            std::this_thread::yield();
+          checksum += msg->words[0] + msg->words[Bytes / 8 - 1];
+          ring.release();
+        } else {
+          while (!ring.pop(out))
+            std::this_thread::yield();
+          checksum += out.words[0] + out.words[Bytes / 8 - 1];
+        }
+      }
+    });
+    for (std::size_t i = 0; i < N; ++i) {
+      if (in_place) {
+        Message *slot;
+        while (!(slot = ring.try_claim()))
+          std::this_thread::yield();
+        for (auto &w : slot->words)
+          w = i;
+        ring.commit(slot);
+      } else {
+        Message msg;
+        for (auto &w : msg.words)
+          w = i;
+        while (!ring.push(msg))
+          std::this_thread::yield();
+      }
+    }
+    consumer.join();
+    uint64_t elapsed = timer.elapsed_ns();
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "  │  %3zuB %-30s %8.1f ns/op\n", Bytes,
+                  in_place ? "try_claim/commit, peek/release"
+                           : "push/pop (two copies)",
+                  static_cast<double>(elapsed) / N);
+    std::cout << line;
+    if (checksum != N * (N - 1))
+      std::cout << "  │  [!!] stream lost or reordered messages\n";
+  }
+}
+
 // ═══════════════════════════════════════════════════════════════════════
 //  Main
 // ═══════════════════════════════════════════════════════════════════════
@@ -325,6 +1776,72 @@ int main() {
     MemoryArena arena(128 * 1024 * 1024);
     bench_full_pipeline(arena);
   }
+  bench_shard_scaling();
+  for (bool with_sink : {false, true}) {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_execution_reports(arena, with_sink);
+  }
+  bench_pool_contention();
+  {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_cancel_heavy(arena);
+  }
+  for (std::size_t live : {1'000'000, 10'000'000})
+    bench_order_id_index(live);
+  for (bool cross_on_entry : {false, true}) {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_marketable_limit(arena, cross_on_entry);
+  }
+  for (bool in_place : {false, true}) {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_amend(arena, in_place);
+  }
+  for (bool chained : {false, true}) {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_mass_cancel(arena, chained);
+  }
+  for (std::size_t parked : {0, 100'000}) {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_stop_check(arena, parked);
+  }
+  for (bool iceberg : {false, true}) {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_iceberg(arena, iceberg);
+  }
+  bench_call_auction();
+  {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_matching_policy<PriceTimePriority>(
+        arena, "Taker for 1/5 of a 100-order level, price-time");
+  }
+  {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_matching_policy<ProRata>(
+        arena, "Taker for 1/5 of a 100-order level, pro-rata");
+  }
+  for (bool with_feed : {false, true}) {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_market_data(arena, with_feed);
+  }
+  bench_top_of_book();
+  {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_snapshot(arena);
+  }
+  for (bool with_feed : {false, true}) {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_order_feed(arena, with_feed);
+  }
+  for (std::size_t readers : {0, 2}) {
+    MemoryArena arena(64 * 1024 * 1024);
+    bench_depth_cache(arena, readers);
+  }
+  bench_ring_transfer();
+  bench_gateway_scaling();
+  std::cout << "\n  ┌─ Inbound ring, copy vs. in place\n";
+  bench_zero_copy<sizeof(OrderMessage)>();
+  bench_zero_copy<256>();
+  std::cout << "  └──────────────────────────────\n";
 
   std::cout << "\n══════════════════════════════════════════════════\n"
             << "  Benchmark complete.\n"
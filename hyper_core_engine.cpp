@@ -7,9 +7,9 @@
  *
  * Architecture:
  *
- *   ┌───────────────────┐       SPSC RingBuffer        ┌──────────────────┐
+ *   ┌───────────────────┐       MPSC RingBuffer        ┌──────────────────┐
  *   │ GatewaySimulator  │ ────────(lock-free)────────▶ │  MatcherThread   │
- *   │ (Producer Thread) │                               │ (Pinned to Core) │
+ *   │(Producer Threads) │                               │ (Pinned to Core) │
  *   └───────────────────┘                               └────────┬─────────┘
  *                                                                │
  *                                              ┌─────────────────┼────────────┐
@@ -25,12 +25,28 @@
  * Components:
  *   1.  MemoryArena           -> Bump allocator, zero-fragmentation
  *   2.  ObjectPool<T>         -> Intrusive free-list, zero-alloc hot path
- *   3.  LockFreeRingBuffer<T> -> SPSC with cache-line isolation
- *   4.  Order / OrderMessage  -> Cache-line-aligned data structures
- *   5.  PriceLevel            -> Intrusive linked list of orders at one price
- *   6.  OrderBook             -> Bid/Ask sides, price-time matching
- *   7.  MatcherThread         -> Pinned busy-spin event loop
- *   8.  GatewaySimulator      -> Synthetic order generator
+ *   3.  ConcurrentObjectPool  -> Per-thread magazines, lock-free depots
+ *   4.  LockFreeRingBuffer<T> -> SPSC with cache-line isolation
+ *   5.  MpscRingBuffer<T>     -> Per-slot sequences, many gateways -> matcher
+ *   6.  Order / OrderMessage  -> Cache-line-aligned data structures
+ *   7.  PriceLevel            -> Intrusive linked list of orders at one price
+ *   8.  OccupancyBitmap<N>    -> 3-level bitset of non-empty price levels
+ *   9.  Call auction search   -> SIMD equilibrium price over level arrays
+ *   10. Matching policies     -> Price-time FIFO or pro-rata, per book type
+ *   11. OrderBook             -> Bid/Ask sides, policy matching, auctions
+ *   12. InstrumentDirectory   -> instrument_id -> dense per-instrument book
+ *   13. OwnerIndex            -> Per-session order chains (mass cancel)
+ *   14. ExecutionSink         -> Per-fill ExecutionReport stream out of books
+ *   15. MarketDataSink        -> L2 level deltas, coalesced per message
+ *   16. OrderFeedSink         -> L3 order-by-order events from book mutations
+ *   17. TopOfBookCell         -> Seqlock L1 snapshot, readable from any thread
+ *   18. DepthCacheCell        -> Conflated top-N depth for slow subscribers
+ *   19. MatcherThread         -> Pinned busy-spin event loop
+ *   20. MatcherShard          -> Per-core ring + pool + books (sharded mode)
+ *   21. ExecutionConsumer     -> Drains every shard's execution ring
+ *   22. MarketDataConsumer    -> Drains L2/L3 feeds, counts sequence gaps
+ *   23. DepthCacheSubscriber  -> Slow poller of the conflated depth cache
+ *   24. GatewaySimulator      -> Synthetic order generator
  *
  * Decisions:
  *   | Decision               | Alternative        | Rationale |
@@ -52,21 +68,26 @@
 //  1. INCLUDES
 // ═══════════════════════════════════════════════════════════════════════
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <concepts>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <new>
 #include <random>
 
 #include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #ifdef _WIN32
@@ -76,6 +97,14 @@
 #include <sched.h>
 #endif
 
+// SSE2 is baseline on x86-64; elsewhere the scalar paths are used
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HYPER_CORE_SSE2 1
+#else
+#define HYPER_CORE_SSE2 0
+#endif
+
 // ═══════════════════════════════════════════════════════════════════════
 //  2. CONSTANTS & CONFIGURATION
 // ═══════════════════════════════════════════════════════════════════════
@@ -87,16 +116,40 @@ inline constexpr std::size_t RING_BUFFER_CAPACITY = 1
                                                     << 16; // 65536, power-of-2
 inline constexpr std::size_t ARENA_SIZE_BYTES = 64 * 1024 * 1024; // 64 MB
 inline constexpr std::size_t MAX_ORDERS = 500'000;
-inline constexpr std::size_t MAX_PRICE_LEVELS = 10'000;
-inline constexpr std::size_t MAX_ORDERS_PER_LEVEL = 1'024;
-inline constexpr std::size_t ORDER_ID_MAP_SIZE = 1 << 20; // 1M slots
+inline constexpr std::size_t RECLAIM_BATCH = 32; // dead orders freed per loop
+inline constexpr std::size_t MATCHER_BATCH = 32;  // messages per drain pass
+inline constexpr std::size_t COMPACT_BUDGET = 16; // sweep work per idle poll
+inline constexpr std::size_t POOL_MAGAZINE_SIZE = 62; // 8B header + 62 x 4B
+inline constexpr std::size_t POOL_MAX_CACHES = 32;    // threads per pool
+inline constexpr std::size_t PRICE_WINDOW_LEVELS = 4'096; // per side, power-of-2
+inline constexpr int64_t DEFAULT_TICK_SIZE = 10;           // $0.0010
+inline constexpr uint32_t PRO_RATA_TOP_CAP = 100; // top-of-queue priority fill
+inline constexpr std::size_t MARKET_DATA_BATCH = 256; // dirty levels per flush
+inline constexpr std::size_t CONFLATED_DEPTH = 10; // levels per side cached
+inline constexpr std::size_t ORDER_ID_MAX_PROBE = 32; // id index displacement cap
+inline constexpr std::size_t MAX_INSTRUMENTS = 1'024;      // dense book slots
+inline constexpr std::size_t INSTRUMENT_ID_SPACE = 1 << 16; // direct-mapped ids
+inline constexpr std::size_t SIM_INSTRUMENT_COUNT = 100;
+inline constexpr std::size_t MAX_OWNERS = 4'096;    // sessions with chains
+inline constexpr std::size_t SIM_SESSION_COUNT = 32; // owner IDs 1..32
+inline constexpr int SLOW_SUBSCRIBER_PERIOD_US = 1'000; // depth cache poll
 inline constexpr int MATCHER_CORE_ID = 1;                 // pin to core 1
+inline constexpr std::size_t MATCHER_SHARD_COUNT = 1; // default, argv[1] overrides
+inline constexpr std::size_t MAX_SHARDS = 16;         // shard i -> core 1 + i
+inline constexpr std::size_t GATEWAY_THREAD_COUNT = 1; // argv[2] overrides
+inline constexpr std::size_t MAX_GATEWAYS = 16;        // gateway threads
 inline constexpr int64_t PRICE_MULTIPLIER = 10'000; // fixed-point: 4 decimals
 inline constexpr int64_t MID_PRICE = 1'000'000;     // $100.0000 in fixed-point
+static_assert((PRICE_WINDOW_LEVELS & (PRICE_WINDOW_LEVELS - 1)) == 0,
+              "Price window must be a power of 2 (ring indexing)");
 inline constexpr std::size_t GATEWAY_ORDER_COUNT = 200'000;
-inline constexpr double LIMIT_ORDER_RATIO = 0.70;
-inline constexpr double MARKET_ORDER_RATIO = 0.20;
-// Cancel ratio = 1.0 - LIMIT - MARKET = 0.10
+inline constexpr double LIMIT_ORDER_RATIO = 0.50;
+inline constexpr double STOP_ORDER_RATIO = 0.05; // half STOP, half STOP_LIMIT
+inline constexpr double ICEBERG_RATIO = 0.10;    // of limit orders, ~10% shown
+inline constexpr double MARKET_ORDER_RATIO = 0.15;
+inline constexpr double REPLACE_ORDER_RATIO = 0.20; // rest: cancels
+inline constexpr double MASS_CANCEL_RATIO = 0.0001;  // session disconnects
+// Cancel ratio = 1.0 - LIMIT - STOP - MARKET - REPLACE - MASS_CANCEL ~ 0.10
 
 } // namespace config
 
@@ -117,12 +170,57 @@ concept BoundedSize = sizeof(T) <= 4096;
 template <typename T>
 concept PoolEligible = TriviallySafe<T> && BoundedSize<T>;
 
+/// Anything that takes a T* back for reuse (ObjectPool, a pool Cache).
+template <typename P, typename T>
+concept RecyclerOf = requires(P &pool, T *obj) { pool.release(obj); };
+
 /// Callable that accepts a reference to T (for ring buffer consumer callbacks).
 template <typename F, typename T>
 concept ConsumerOf = std::invocable<F, T &>;
 
 // ═══════════════════════════════════════════════════════════════════════
-//  4. MEMORY ARENA — Bump Allocator (zero fragmentation)
+//  4. CPU PINNING — Platform-specific thread affinity
+// ═══════════════════════════════════════════════════════════════════════
+
+namespace platform {
+
+/// Pin the calling thread to a specific CPU core.
+/// Prevents context switches and ensures cache locality.
+inline bool pin_thread_to_core(int core_id) {
+#ifdef _WIN32
+  DWORD_PTR mask = static_cast<DWORD_PTR>(1) << core_id;
+  HANDLE thread = GetCurrentThread();
+  DWORD_PTR prev = SetThreadAffinityMask(thread, mask);
+  return prev != 0;
+#else
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(core_id, &cpuset);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) ==
+         0;
+#endif
+}
+
+/// Get current timestamp in nanoseconds (monotonic clock).
+[[nodiscard]] inline uint64_t timestamp_ns() noexcept {
+  auto now = std::chrono::steady_clock::now();
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          now.time_since_epoch())
+          .count());
+}
+
+/// Spin-wait hint: yields the core's pipeline to a sibling hyperthread.
+inline void cpu_relax() noexcept {
+#if HYPER_CORE_SSE2
+  _mm_pause();
+#endif
+}
+
+} // namespace platform
+
+// ═══════════════════════════════════════════════════════════════════════
+//  5. MEMORY ARENA — Bump Allocator (zero fragmentation)
 // ═══════════════════════════════════════════════════════════════════════
 
 /// Pre-allocates a single contiguous block. O(1) bump-pointer allocation.
@@ -207,7 +305,7 @@ private:
 };
 
 // ═══════════════════════════════════════════════════════════════════════
-//  5. OBJECT POOL — Zero-Allocation Recycler
+//  6. OBJECT POOL — Zero-Allocation Recycler
 // ═══════════════════════════════════════════════════════════════════════
 
 /// Intrusive free-list object pool backed by MemoryArena.
@@ -277,6 +375,9 @@ public:
   }
   [[nodiscard]] std::size_t capacity() const noexcept { return max_objects_; }
 
+  /// First of the capacity() contiguous slots.
+  [[nodiscard]] T *data() noexcept { return storage_; }
+
 private:
   T *storage_;
   uint32_t *free_stack_;
@@ -285,7 +386,281 @@ private:
 };
 
 // ═══════════════════════════════════════════════════════════════════════
-//  6. LOCK-FREE RING BUFFER — SPSC (Single Producer Single Consumer)
+//  7. CONCURRENT OBJECT POOL — Per-thread magazines, lock-free depots
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Cross-thread object pool for the producer-acquires / consumer-releases
+/// split (the gateway allocates orders, the matcher frees them).
+///
+/// Design:
+///   - Free slot indices travel in magazines of POOL_MAGAZINE_SIZE
+///   - Each thread owns a Cache holding one magazine: acquire() and release()
+///   touch only that thread's memory, no atomics on the common path
+///   - Magazines change hands through two depots (full, empty), each a
+///   lock-free Treiber stack of magazine indices with a 32-bit ABA tag.
+///   Returning a full magazine is one CAS for POOL_MAGAZINE_SIZE objects:
+///   the batched return channel
+///   - Depots hold whole magazines only. A cache that goes away holding a
+///   partly filled one merges it into the single parked partial magazine,
+///   so short-lived caches (a thread per session) never leave a magazine
+///   each behind and the empty depot cannot run dry
+///   - Depot heads, the parked partial and the depot object counter each
+///   own a cache line
+///   - Objects and magazines come from the MemoryArena at construction
+///
+/// Free objects parked in a cache's magazine (at most POOL_MAGAZINE_SIZE
+/// per cache) are invisible to other threads until it swaps magazines or is
+/// destroyed: size the pool with that slack.
+///
+/// Complexity: acquire() / release() O(1), one CAS pair per magazine swap
+template <PoolEligible T> class ConcurrentObjectPool {
+  static constexpr uint32_t NIL = UINT32_MAX;
+  static constexpr std::size_t MAG_SIZE = config::POOL_MAGAZINE_SIZE;
+
+  struct Magazine {
+    std::atomic<uint32_t> next{NIL}; // Depot link (index)
+    uint32_t count = 0;              // Free slot indices held
+    uint32_t slots[MAG_SIZE];
+  };
+  static_assert(sizeof(Magazine) % config::CACHE_LINE_SIZE == 0,
+                "Magazine must span whole cache lines");
+
+  /// Treiber stack head: (tag << 32) | magazine index.
+  struct alignas(config::CACHE_LINE_SIZE) Depot {
+    std::atomic<uint64_t> head{NIL};
+  };
+
+  /// The one partly filled magazine outside any cache (index, or NIL).
+  struct alignas(config::CACHE_LINE_SIZE) Parked {
+    std::atomic<uint32_t> index{NIL};
+  };
+
+  struct alignas(config::CACHE_LINE_SIZE) AlignedCounter {
+    std::atomic<std::size_t> value{0};
+  };
+
+public:
+  /// Per-thread handle. Use each Cache from one thread at a time only.
+  class alignas(config::CACHE_LINE_SIZE) Cache {
+  public:
+    explicit Cache(ConcurrentObjectPool &pool)
+        : pool_(&pool), mag_(pool.pop(pool.empty_)) {
+      if (!mag_) // More caches than POOL_MAX_CACHES: start on a full one
+        mag_ = pool.pop_full();
+      if (!mag_) [[unlikely]] {
+        std::cerr << "[FATAL] ConcurrentObjectPool: no magazine for cache\n";
+        std::abort();
+      }
+    }
+
+    ~Cache() {
+      if (mag_)
+        pool_->give_back(mag_);
+    }
+
+    Cache(Cache &&other) noexcept
+        : pool_(other.pool_), mag_(std::exchange(other.mag_, nullptr)) {}
+    Cache(const Cache &) = delete;
+    Cache &operator=(const Cache &) = delete;
+    Cache &operator=(Cache &&) = delete;
+
+    /// Acquire an object. O(1). Returns nullptr if the pool is exhausted.
+    [[nodiscard]] T *acquire() noexcept {
+      if (mag_->count == 0) [[unlikely]] {
+        Magazine *full = pool_->pop_full();
+        if (!full)
+          return nullptr;
+        pool_->push(pool_->empty_, mag_);
+        mag_ = full;
+      }
+      uint32_t idx = mag_->slots[--mag_->count];
+      return ::new (static_cast<void *>(&pool_->storage_[idx])) T{};
+    }
+
+    /// Release an object acquired from any cache of the same pool. O(1).
+    void release(T *obj) noexcept {
+      if (!obj) [[unlikely]]
+        return;
+      auto idx = static_cast<uint32_t>(obj - pool_->storage_);
+      assert(idx < pool_->max_objects_ && "release: pointer not from this pool");
+      obj->~T();
+
+      if (mag_->count == MAG_SIZE) [[unlikely]] {
+        Magazine *empty = pool_->pop(pool_->empty_);
+        // Ruled out by the magazine slack while at most POOL_MAX_CACHES
+        // caches are alive at once
+        if (!empty) [[unlikely]] {
+          std::cerr << "[FATAL] ConcurrentObjectPool: empty depot drained\n";
+          std::abort();
+        }
+        pool_->push_full(mag_);
+        mag_ = empty;
+      }
+      mag_->slots[mag_->count++] = idx;
+    }
+
+  private:
+    ConcurrentObjectPool *pool_;
+    Magazine *mag_;
+  };
+
+  ConcurrentObjectPool(MemoryArena &arena, std::size_t max_objects)
+      : max_objects_(max_objects), magazine_count_(magazines_for(max_objects)) {
+    storage_ = arena.allocate<T>(max_objects);
+    magazines_ = arena.allocate<Magazine>(magazine_count_);
+
+    // Fill magazines with every slot index; the remainder start empty
+    std::size_t next_slot = 0;
+    for (std::size_t m = 0; m < magazine_count_; ++m) {
+      auto *mag = ::new (static_cast<void *>(&magazines_[m])) Magazine{};
+      while (mag->count < MAG_SIZE && next_slot < max_objects)
+        mag->slots[mag->count++] = static_cast<uint32_t>(next_slot++);
+      give_back(mag); // the last, partly filled one is parked
+    }
+  }
+
+  ConcurrentObjectPool(const ConcurrentObjectPool &) = delete;
+  ConcurrentObjectPool &operator=(const ConcurrentObjectPool &) = delete;
+
+  /// Arena bytes needed for `max_objects` (objects + magazines + slack).
+  [[nodiscard]] static std::size_t arena_bytes(std::size_t max_objects) {
+    return max_objects * sizeof(T) +
+           magazines_for(max_objects) * sizeof(Magazine) +
+           2 * config::CACHE_LINE_SIZE; // alignment slack
+  }
+
+  // ─────────── Stats (exact only while no cache holds objects) ───────────
+
+  /// Free objects in the depots and the parked partial magazine, i.e. not
+  /// held in any cache.
+  [[nodiscard]] std::size_t available() const noexcept {
+    return depot_objects_.value.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] std::size_t in_use() const noexcept {
+    return max_objects_ - available();
+  }
+  [[nodiscard]] std::size_t capacity() const noexcept { return max_objects_; }
+
+  /// First of the capacity() contiguous slots.
+  [[nodiscard]] T *data() noexcept { return storage_; }
+
+private:
+  /// Enough magazines for every object, plus one spare and one partial per
+  /// cache and the parked partial, so a cache that has to swap always
+  /// finds an empty magazine.
+  [[nodiscard]] static std::size_t magazines_for(std::size_t max_objects) {
+    return (max_objects + MAG_SIZE - 1) / MAG_SIZE +
+           2 * config::POOL_MAX_CACHES + 1;
+  }
+
+  [[nodiscard]] static uint64_t pack(uint64_t tag, uint32_t idx) noexcept {
+    return (tag << 32) | idx;
+  }
+
+  void push(Depot &depot, Magazine *mag) noexcept {
+    auto idx = static_cast<uint32_t>(mag - magazines_);
+    uint64_t old = depot.head.load(std::memory_order_relaxed);
+    uint64_t desired;
+    do {
+      mag->next.store(static_cast<uint32_t>(old), std::memory_order_relaxed);
+      desired = pack((old >> 32) + 1, idx);
+    } while (!depot.head.compare_exchange_weak(old, desired,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+  }
+
+  [[nodiscard]] Magazine *pop(Depot &depot) noexcept {
+    uint64_t old = depot.head.load(std::memory_order_acquire);
+    while (static_cast<uint32_t>(old) != NIL) {
+      Magazine *mag = &magazines_[static_cast<uint32_t>(old)];
+      uint32_t next = mag->next.load(std::memory_order_relaxed);
+      if (depot.head.compare_exchange_weak(old, pack((old >> 32) + 1, next),
+                                           std::memory_order_acquire,
+                                           std::memory_order_acquire))
+        return mag;
+    }
+    return nullptr;
+  }
+
+  void push_full(Magazine *mag) noexcept {
+    depot_objects_.value.fetch_add(mag->count, std::memory_order_relaxed);
+    push(full_, mag);
+  }
+
+  /// A full magazine, else the parked partial one, else nullptr.
+  [[nodiscard]] Magazine *pop_full() noexcept {
+    Magazine *mag = pop(full_);
+    if (!mag)
+      return take_parked();
+    depot_objects_.value.fetch_sub(mag->count, std::memory_order_relaxed);
+    return mag;
+  }
+
+  [[nodiscard]] Magazine *take_parked() noexcept {
+    uint32_t idx = parked_.index.exchange(NIL, std::memory_order_acquire);
+    if (idx == NIL)
+      return nullptr;
+    Magazine *mag = &magazines_[idx];
+    depot_objects_.value.fetch_sub(mag->count, std::memory_order_relaxed);
+    return mag;
+  }
+
+  /// Park `mag` as the partial magazine. Fails if another one is parked.
+  [[nodiscard]] bool park(Magazine *mag) noexcept {
+    // Counted first: whoever takes it next subtracts its count
+    depot_objects_.value.fetch_add(mag->count, std::memory_order_relaxed);
+    uint32_t expected = NIL;
+    if (parked_.index.compare_exchange_strong(
+            expected, static_cast<uint32_t>(mag - magazines_),
+            std::memory_order_release, std::memory_order_relaxed))
+      return true;
+    depot_objects_.value.fetch_sub(mag->count, std::memory_order_relaxed);
+    return false;
+  }
+
+  /// Return a cache's magazine. Empty and full ones go to their depots; a
+  /// partial one is topped up from the parked partial until one of the two
+  /// is full or empty, so at most one partial magazine is ever parked.
+  void give_back(Magazine *mag) noexcept {
+    for (;;) {
+      if (mag->count == 0) {
+        push(empty_, mag);
+        return;
+      }
+      if (mag->count == MAG_SIZE) {
+        push_full(mag);
+        return;
+      }
+      Magazine *parked = take_parked();
+      if (!parked) {
+        if (park(mag))
+          return;
+        continue; // another partial got parked first: merge with it
+      }
+      while (parked->count > 0 && mag->count < MAG_SIZE)
+        mag->slots[mag->count++] = parked->slots[--parked->count];
+      if (parked->count == 0) {
+        push(empty_, parked);
+      } else { // `mag` is full now; carry on with the rest
+        push_full(mag);
+        mag = parked;
+      }
+    }
+  }
+
+  Depot full_;    // Magazines holding MAG_SIZE free objects
+  Depot empty_;   // Magazines holding none
+  Parked parked_; // At most one partly filled magazine
+  AlignedCounter depot_objects_;
+
+  T *storage_;
+  Magazine *magazines_;
+  std::size_t max_objects_;
+  std::size_t magazine_count_;
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+//  8. LOCK-FREE RING BUFFER — SPSC (Single Producer Single Consumer)
 // ═══════════════════════════════════════════════════════════════════════
 
 /// Cache-line-isolated SPSC ring buffer with acquire/release semantics.
@@ -296,8 +671,17 @@ private:
 ///   - Producer: store(tail_, release) — data visible before index advances
 ///   - Consumer: load(tail_, acquire) — sees data written before tail advanced
 ///   - No CAS loops needed (single producer, single consumer)
+///   - Each side keeps a private copy of the other side's index on its own
+///   line (producer: head, consumer: tail) and re-reads the shared one only
+///   when the copy says full / empty. While the ring is neither, a push or
+///   pop touches no line the other thread writes
+///   - push_bulk() / pop_bulk() move up to N items with one index store, so
+///   the other side's copy of that index is invalidated once per batch
+///   - Zero-copy: try_claim() / commit() let the producer build the item in
+///   its slot, peek() / release() let the consumer use it there. push() and
+///   pop() are the same calls around one copy each
 ///
-/// Complexity: push() O(1), pop() O(1)
+/// Complexity: push() O(1), pop() O(1), push_bulk()/pop_bulk() O(n)
 /// Latency:    ~5-15ns per operation (no syscalls, no contention)
 template <PoolEligible T> class LockFreeRingBuffer {
   static_assert((config::RING_BUFFER_CAPACITY &
@@ -312,43 +696,112 @@ public:
 
   // ─────────── Producer API (single thread) ───────────
 
-  /// Push an element. Returns false if buffer is full (back-pressure).
-  [[nodiscard]] bool push(const T &item) noexcept {
+  /// Next free slot, to be filled in place and published with commit().
+  /// Returns nullptr if buffer is full (back-pressure). Until commit() the
+  /// consumer cannot see the slot; claiming again returns the same one.
+  [[nodiscard]] T *try_claim() noexcept {
     const uint64_t current_tail = tail_.value.load(std::memory_order_relaxed);
     const uint64_t next_tail = current_tail + 1;
 
-    // Full check: if next_tail catches up to head, buffer is full
-    if (next_tail - head_.value.load(std::memory_order_acquire) > mask_)
-        [[unlikely]] {
-      return false;
+    // Full check: if next_tail catches up to head, buffer is full. Only a
+    // full-looking ring costs a load of the consumer's line
+    if (next_tail - tail_.cached > mask_) [[unlikely]] {
+      tail_.cached = head_.value.load(std::memory_order_acquire);
+      if (next_tail - tail_.cached > mask_)
+        return nullptr;
     }
+    return &buffer_[current_tail & mask_];
+  }
 
-    buffer_[current_tail & mask_] = item;
+  /// Publish the slot returned by the last try_claim().
+  void commit() noexcept {
+    const uint64_t current_tail = tail_.value.load(std::memory_order_relaxed);
 
     // Release: ensure the data write is visible before tail advances
-    tail_.value.store(next_tail, std::memory_order_release);
+    tail_.value.store(current_tail + 1, std::memory_order_release);
+  }
+
+  /// Push an element. Returns false if buffer is full (back-pressure).
+  [[nodiscard]] bool push(const T &item) noexcept {
+    T *slot = try_claim();
+    if (!slot) [[unlikely]]
+      return false;
+    *slot = item;
+    commit();
     return true;
   }
 
+  /// Push up to `count` elements from `items`, in order, and publish them
+  /// with a single tail store. Returns how many fit (0 if full).
+  [[nodiscard]] std::size_t push_bulk(const T *items,
+                                      std::size_t count) noexcept {
+    const uint64_t current_tail = tail_.value.load(std::memory_order_relaxed);
+    std::size_t room = free_slots(current_tail, tail_.cached);
+    if (room < count) [[unlikely]] {
+      tail_.cached = head_.value.load(std::memory_order_acquire);
+      room = free_slots(current_tail, tail_.cached);
+    }
+    const std::size_t n = std::min(count, room);
+    for (std::size_t i = 0; i < n; ++i)
+      buffer_[(current_tail + i) & mask_] = items[i];
+
+    if (n > 0)
+      tail_.value.store(current_tail + n, std::memory_order_release);
+    return n;
+  }
+
   // ─────────── Consumer API (single thread) ───────────
 
-  /// Pop an element. Returns false if buffer is empty.
-  [[nodiscard]] bool pop(T &out) noexcept {
+  /// Oldest element, left in its slot until release(). Returns nullptr if
+  /// buffer is empty.
+  [[nodiscard]] const T *peek() noexcept {
     const uint64_t current_head = head_.value.load(std::memory_order_relaxed);
 
-    // Empty check: head has caught up to tail
-    if (current_head >= tail_.value.load(std::memory_order_acquire))
-        [[unlikely]] {
-      return false;
+    // Empty check: head has caught up to tail. Only an empty-looking ring
+    // costs a load of the producer's line
+    if (current_head >= head_.cached) [[unlikely]] {
+      head_.cached = tail_.value.load(std::memory_order_acquire);
+      if (current_head >= head_.cached)
+        return nullptr;
     }
+    return &buffer_[current_head & mask_];
+  }
 
-    out = buffer_[current_head & mask_];
+  /// Hand the slot returned by peek() back to the producer.
+  void release() noexcept {
+    const uint64_t current_head = head_.value.load(std::memory_order_relaxed);
 
     // Release: ensure the read is complete before head advances
     head_.value.store(current_head + 1, std::memory_order_release);
+  }
+
+  /// Pop an element. Returns false if buffer is empty.
+  [[nodiscard]] bool pop(T &out) noexcept {
+    const T *slot = peek();
+    if (!slot)
+      return false;
+    out = *slot;
+    release();
     return true;
   }
 
+  /// Pop up to `max` elements into `out`, in order, and release their slots
+  /// with a single head store. Returns how many were popped (0 if empty).
+  [[nodiscard]] std::size_t pop_bulk(T *out, std::size_t max) noexcept {
+    const uint64_t current_head = head_.value.load(std::memory_order_relaxed);
+    if (head_.cached - current_head < max) {
+      head_.cached = tail_.value.load(std::memory_order_acquire);
+    }
+    const std::size_t n = static_cast<std::size_t>(
+        std::min<uint64_t>(max, head_.cached - current_head));
+    for (std::size_t i = 0; i < n; ++i)
+      out[i] = buffer_[(current_head + i) & mask_];
+
+    if (n > 0)
+      head_.value.store(current_head + n, std::memory_order_release);
+    return n;
+  }
+
   // ─────────── Stats ───────────
 
   [[nodiscard]] std::size_t size() const noexcept {
@@ -365,19 +818,205 @@ private:
 
   struct alignas(config::CACHE_LINE_SIZE) AlignedAtomic {
     std::atomic<uint64_t> value{0};
+    uint64_t cached = 0; // owner's last view of the other side's index
     // Padding is implicit: alignas(64) ensures the struct occupies
     // a full cache line, so the next member starts on a new line.
   };
 
-  AlignedAtomic head_; // Written by consumer ONLY
-  AlignedAtomic tail_; // Written by producer ONLY
+  /// Slots the producer may fill, with the consumer at `head`. One slot
+  /// always stays empty, as in push().
+  [[nodiscard]] std::size_t free_slots(uint64_t tail,
+                                       uint64_t head) const noexcept {
+    return static_cast<std::size_t>(mask_ - (tail - head));
+  }
+
+  AlignedAtomic head_; // Written by consumer ONLY (cached: its view of tail)
+  AlignedAtomic tail_; // Written by producer ONLY (cached: its view of head)
 
   T *buffer_;
   uint64_t mask_;
 };
 
 // ═══════════════════════════════════════════════════════════════════════
-//  7. ORDER TYPES & DATA STRUCTURES
+//  9. MPSC RING BUFFER — Many session threads into one matcher
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Bounded multi-producer / single-consumer ring: one sequence number per
+/// slot says whose turn it is.
+///
+/// Design:
+///   - Slot i of round r holds sequence r*C + i while free for the producer
+///   of that position, and r*C + i + 1 once the item is in: the consumer
+///   never looks at the producers' tail, only at the slot it reads next
+///   - Producers claim a position with one CAS on the shared tail_ (its own
+///   cache line), copy the item in, then release the slot's sequence. Each
+///   producer's items come out in the order it pushed them
+///   - Consumer side is as cheap as the SPSC ring: an acquire load of the
+///   slot's sequence, the copy, a release store handing the slot to the next
+///   round. pop_bulk() walks ready slots up to the first one still empty
+///   - A producer preempted between its CAS and its release holds back the
+///   items behind it (the consumer sees an empty ring meanwhile); it never
+///   blocks the other producers
+///   - Zero-copy: try_claim() / commit(slot) and peek() / release() are the
+///   two halves of push() and pop() without the copy. A claimed slot holds
+///   back the consumer like a preempted push, so fill it and commit at once
+///   - Uses the full capacity; slots come from the MemoryArena
+///
+/// Complexity: push() O(1) (a CAS retry per concurrent push that won the
+/// slot), pop() O(1), pop_bulk() O(n)
+template <PoolEligible T> class MpscRingBuffer {
+  static_assert((config::RING_BUFFER_CAPACITY &
+                 (config::RING_BUFFER_CAPACITY - 1)) == 0,
+                "Ring buffer capacity must be a power of 2");
+
+  struct Slot {
+    std::atomic<uint64_t> sequence;
+    T value;
+  };
+
+public:
+  explicit MpscRingBuffer(MemoryArena &arena)
+      : mask_(config::RING_BUFFER_CAPACITY - 1) {
+    slots_ = arena.allocate<Slot>(config::RING_BUFFER_CAPACITY);
+    for (std::size_t i = 0; i < config::RING_BUFFER_CAPACITY; ++i)
+      new (&slots_[i].sequence) std::atomic<uint64_t>(i);
+  }
+
+  MpscRingBuffer(const MpscRingBuffer &) = delete;
+  MpscRingBuffer &operator=(const MpscRingBuffer &) = delete;
+
+  /// Bytes the ring takes from its MemoryArena, alignment slack included
+  /// (a whole number of cache lines, as MemoryArena requires).
+  [[nodiscard]] static constexpr std::size_t arena_bytes() noexcept {
+    return (config::RING_BUFFER_CAPACITY * sizeof(Slot) +
+            2 * config::CACHE_LINE_SIZE - 1) &
+           ~(config::CACHE_LINE_SIZE - 1);
+  }
+
+  // ─────────── Producer API (any number of threads) ───────────
+
+  /// Reserve the next position and return its slot, to be filled in place
+  /// and published with commit(slot). Returns nullptr if buffer is full.
+  [[nodiscard]] T *try_claim() noexcept {
+    uint64_t pos = tail_.value.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot &slot = slots_[pos & mask_];
+      const uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+      const auto lag = static_cast<int64_t>(seq - pos);
+      if (lag == 0) {
+        // Slot is free for position `pos`: try to claim it
+        if (tail_.value.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed))
+          return &slot.value;
+      } else if (lag < 0) [[unlikely]] {
+        return nullptr; // still holds the item of the previous round
+      } else {
+        pos = tail_.value.load(std::memory_order_relaxed); // taken, retry
+      }
+    }
+  }
+
+  /// Publish a slot returned by try_claim(). Claims may be committed in any
+  /// order; the consumer takes them in claim order.
+  void commit(T *claimed) noexcept {
+    Slot &slot = slots_[slot_index(claimed)];
+    // Until now the sequence still reads the claimed position
+    const uint64_t pos = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(pos + 1, std::memory_order_release);
+  }
+
+  /// Push an element. Returns false if buffer is full (back-pressure).
+  [[nodiscard]] bool push(const T &item) noexcept {
+    T *slot = try_claim();
+    if (!slot) [[unlikely]]
+      return false;
+    *slot = item;
+    commit(slot);
+    return true;
+  }
+
+  // ─────────── Consumer API (single thread) ───────────
+
+  /// Oldest element, left in its slot until release(). Returns nullptr if
+  /// buffer is empty or its oldest slot is claimed but not yet committed.
+  [[nodiscard]] const T *peek() noexcept {
+    const uint64_t pos = head_.value.load(std::memory_order_relaxed);
+    Slot &slot = slots_[pos & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+      return nullptr;
+    return &slot.value;
+  }
+
+  /// Hand the slot returned by peek() to the producers' next round.
+  void release() noexcept {
+    const uint64_t pos = head_.value.load(std::memory_order_relaxed);
+
+    // Release: the reads are done before producers may reuse the slot
+    slots_[pos & mask_].sequence.store(pos + mask_ + 1,
+                                       std::memory_order_release);
+    head_.value.store(pos + 1, std::memory_order_relaxed);
+  }
+
+  /// Pop an element. Returns false if buffer is empty.
+  [[nodiscard]] bool pop(T &out) noexcept {
+    const T *slot = peek();
+    if (!slot)
+      return false;
+    out = *slot;
+    release();
+    return true;
+  }
+
+  /// Pop up to `max` elements into `out`, stopping at the first slot not
+  /// yet filled. Returns how many were popped (0 if empty).
+  [[nodiscard]] std::size_t pop_bulk(T *out, std::size_t max) noexcept {
+    const uint64_t pos = head_.value.load(std::memory_order_relaxed);
+    std::size_t n = 0;
+    for (; n < max; ++n) {
+      Slot &slot = slots_[(pos + n) & mask_];
+      if (slot.sequence.load(std::memory_order_acquire) != pos + n + 1)
+        break;
+      out[n] = slot.value;
+      slot.sequence.store(pos + n + mask_ + 1, std::memory_order_release);
+    }
+    if (n > 0)
+      head_.value.store(pos + n, std::memory_order_relaxed);
+    return n;
+  }
+
+  // ─────────── Stats ───────────
+
+  /// Items claimed by producers and not yet popped (some may still be in
+  /// flight). Approximate while producers run.
+  [[nodiscard]] std::size_t size() const noexcept {
+    auto t = tail_.value.load(std::memory_order_relaxed);
+    auto h = head_.value.load(std::memory_order_relaxed);
+    return static_cast<std::size_t>(t - h);
+  }
+
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+private:
+  struct alignas(config::CACHE_LINE_SIZE) AlignedAtomic {
+    std::atomic<uint64_t> value{0};
+  };
+
+  [[nodiscard]] std::size_t slot_index(const T *claimed) const noexcept {
+    return static_cast<std::size_t>(
+        (reinterpret_cast<const char *>(claimed) -
+         reinterpret_cast<const char *>(&slots_[0].value)) /
+        sizeof(Slot));
+  }
+
+  AlignedAtomic head_; // Written by consumer ONLY
+  AlignedAtomic tail_; // Claimed by producers through CAS
+
+  Slot *slots_;
+  uint64_t mask_;
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+//  10. ORDER TYPES & DATA STRUCTURES
 // ═══════════════════════════════════════════════════════════════════════
 
 enum class Side : uint8_t {
@@ -389,72 +1028,211 @@ enum class OrderType : uint8_t {
   LIMIT = 0,
   MARKET = 1,
   CANCEL = 2,
+  REPLACE = 3,     // amend price and/or quantity of a resting order
+  MASS_CANCEL = 4, // cancel every resting order of one owner (session)
+  STOP = 5,        // market order once the last trade reaches the trigger
+  STOP_LIMIT = 6,  // limit order once the last trade reaches the trigger
 };
 
 /// Core order structure — designed to fit in a single cache line (64 bytes).
 ///
 /// Layout:
 ///   id             8B   offset  0
-///   instrument_id  8B   offset  8
+///   instrument_id  2B   offset  8
+///   owner_id       2B   offset 10   (session; 0 = none)
+///   stop_tick /    4B   offset 12   (book-internal: trigger of a parked stop,
+///   peak_qty                         or an iceberg's display size)
 ///   price          8B   offset 16   (fixed-point, price * PRICE_MULTIPLIER)
 ///   quantity       4B   offset 24
-///   remaining_qty  4B   offset 28
+///   remaining_qty  4B   offset 28   (displayed part for an iceberg)
 ///   timestamp      8B   offset 32
-///   side           1B   offset 40
-///   type           1B   offset 41
-///   active         1B   offset 42
-///   (5B implicit)       offset 43   (compiler padding for 8B-aligned next)
-///   next           8B   offset 48   (intrusive list pointer)
+///   hidden_qty     4B   offset 40   (iceberg reserve not yet displayed)
+///   side           1B   offset 44
+///   type           1B   offset 45
+///   active         1B   offset 46
+///   (1B implicit)       offset 47
+///   next           8B   offset 48   (intrusive list pointers)
+///   prev           8B   offset 56
 ///
-/// Total: 56 bytes usable, alignas(64) pads to 64B cache line
+/// Total: 64 bytes, exactly one cache line
 struct alignas(config::CACHE_LINE_SIZE) Order {
   uint64_t id = 0;
-  uint64_t instrument_id = 0;
+  uint16_t instrument_id = 0; // < INSTRUMENT_ID_SPACE
+  uint16_t owner_id = 0;      // Session that sent it; mass cancel key
+
+  // A parked stop never rests on a level and an iceberg is never parked
+  // (submit_stop() refuses one), so the two share a slot
+  union {
+    uint32_t stop_tick = 0; // STOP / STOP_LIMIT: trigger tick while parked
+    uint32_t peak_qty;      // LIMIT: iceberg display size, 0 = fully shown
+  };
+
   int64_t price = 0; // Fixed-point: real_price * 10000
-  uint32_t quantity = 0;
-  uint32_t remaining_qty = 0;
+  uint32_t quantity = 0;      // filled + remaining_qty + hidden_qty
+  uint32_t remaining_qty = 0; // Open quantity on the level
   uint64_t timestamp = 0; // Nanosecond timestamp
+  uint32_t hidden_qty = 0; // Iceberg reserve, shown peak_qty at a time
   Side side = Side::BID;
   OrderType type = OrderType::LIMIT;
   uint8_t active = 0; // 1 = live, 0 = cancelled/filled
 
-  // Intrusive linked list pointer for PriceLevel — eliminates std::vector
-  // and its hidden malloc on the hot path. Compiler inserts 5B padding
-  // between active(offset 42) and next(offset 48) for 8B alignment.
+  // Intrusive doubly-linked list pointers for PriceLevel — eliminate
+  // std::vector and its hidden malloc on the hot path, and let cancel unlink
+  // in O(1).
   Order *next = nullptr;
+  Order *prev = nullptr;
 };
 
 static_assert(sizeof(Order) == config::CACHE_LINE_SIZE,
               "Order must be exactly one cache line");
+static_assert(config::INSTRUMENT_ID_SPACE <= (uint64_t{1} << 16),
+              "Instrument IDs must fit Order::instrument_id");
+static_assert(config::MAX_OWNERS <= (uint64_t{1} << 16),
+              "Owner IDs must fit Order::owner_id");
 static_assert(std::is_trivially_copyable_v<Order>,
               "Order must be trivially copyable for pool/ring");
 
 /// Message envelope for the ring buffer.
-/// Contains either an order pointer (for add/match) or an order ID (for
-/// cancel).
+/// Contains either an order pointer (for add/match/stop) or the ID of a
+/// resting order (for cancel/replace) or of an owner (for mass cancel).
+/// REPLACE carries no Order: the amend is applied to the resting one, so it
+/// never touches the pool.
+///
+/// Layout:
+///   type       1B   offset  0
+///   (3B implicit)   offset  1
+///   new_qty    4B   offset  4   (REPLACE: new open quantity)
+///   order      8B   offset  8
+///   target_id  8B   offset 16   (CANCEL / REPLACE: order ID,
+///                                 MASS_CANCEL: owner ID)
+///   price      8B   offset 24   (REPLACE: new limit price,
+///                                 STOP / STOP_LIMIT: trigger price)
 struct OrderMessage {
   OrderType type = OrderType::LIMIT;
+  uint32_t new_qty = 0;
   Order *order = nullptr; // Non-owning pointer from ObjectPool
-  uint64_t cancel_id = 0; // Only used for CANCEL messages
-
-  // Padding for trivial copy
-  uint8_t _pad[7] = {};
+  uint64_t target_id = 0;
+  int64_t price = 0;
 };
 
+static_assert(sizeof(OrderMessage) == 32,
+              "OrderMessage must stay two per cache line");
 static_assert(std::is_trivially_copyable_v<OrderMessage>,
               "OrderMessage must be trivially copyable for ring buffer");
 
+/// One individual fill between a resting (maker) and an incoming (taker)
+/// order, published by the matcher on the outbound execution ring.
+///
+/// Layout:
+///   maker_order_id   8B   offset  0
+///   taker_order_id   8B   offset  8
+///   instrument_id    8B   offset 16
+///   price            8B   offset 24   (maker's level price, fixed-point)
+///   quantity         4B   offset 32
+///   maker_leaves     4B   offset 36   (maker qty still open, reserve included)
+///   taker_leaves     4B   offset 40
+///   taker_side       1B   offset 44
+///   (3B implicit)         offset 45
+///   taker_timestamp  8B   offset 48   (taker's gateway timestamp)
+///   match_timestamp  8B   offset 56   (matcher clock at the fill)
+///
+/// Total: 64 bytes, one cache line per report
+struct alignas(config::CACHE_LINE_SIZE) ExecutionReport {
+  uint64_t maker_order_id = 0;
+  uint64_t taker_order_id = 0;
+  uint64_t instrument_id = 0;
+  int64_t price = 0;
+  uint32_t quantity = 0;
+  uint32_t maker_leaves = 0;
+  uint32_t taker_leaves = 0;
+  Side taker_side = Side::BID;
+  uint64_t taker_timestamp = 0;
+  uint64_t match_timestamp = 0;
+};
+
+static_assert(sizeof(ExecutionReport) == config::CACHE_LINE_SIZE,
+              "ExecutionReport must be exactly one cache line");
+static_assert(std::is_trivially_copyable_v<ExecutionReport>,
+              "ExecutionReport must be trivially copyable for ring buffer");
+
+/// New aggregate displayed quantity of one price level (L2 market data),
+/// published by the matcher on the outbound market-data ring.
+///
+/// Layout:
+///   sequence       8B   offset  0   (per matcher, gap = deltas dropped)
+///   price          8B   offset  8   (fixed-point)
+///   quantity       4B   offset 16   (0 = level gone)
+///   instrument_id  2B   offset 20
+///   side           1B   offset 22
+///   (1B implicit)       offset 23
+///
+/// Total: 24 bytes, eight deltas per three cache lines
+struct LevelDelta {
+  uint64_t sequence = 0;
+  int64_t price = 0;
+  uint32_t quantity = 0;
+  uint16_t instrument_id = 0;
+  Side side = Side::BID;
+};
+
+static_assert(sizeof(LevelDelta) == 24, "LevelDelta must stay 24 bytes");
+static_assert(std::is_trivially_copyable_v<LevelDelta>,
+              "LevelDelta must be trivially copyable for ring buffer");
+
+enum class OrderEventType : uint8_t {
+  ADD = 0,     // order now rests at the tail of its level, `quantity` shown
+  MODIFY = 1,  // shown size cut in place to `quantity`, priority kept
+  CANCEL = 2,  // order left the book with `quantity` still shown
+  EXECUTE = 3, // `quantity` of the shown size traded; 0 left = order gone
+};
+
+/// One order-by-order change to a book (L3 market data), published by the
+/// matcher on the outbound order-feed ring. Replaying the events in sequence
+/// rebuilds every queue exactly. An amend that loses priority is CANCEL +
+/// ADD; an iceberg slice that trades out is EXECUTE, then ADD of the next
+/// slice at the tail. Hidden reserve is never shown.
+///
+/// Layout:
+///   sequence       8B   offset  0   (per matcher, gap = events dropped)
+///   order_id       8B   offset  8
+///   price          8B   offset 16   (the order's level, fixed-point)
+///   quantity       4B   offset 24
+///   instrument_id  2B   offset 28
+///   side           1B   offset 30
+///   type           1B   offset 31
+///
+/// Total: 32 bytes, two events per cache line
+struct OrderEvent {
+  uint64_t sequence = 0;
+  uint64_t order_id = 0;
+  int64_t price = 0;
+  uint32_t quantity = 0;
+  uint16_t instrument_id = 0;
+  Side side = Side::BID;
+  OrderEventType type = OrderEventType::ADD;
+};
+
+static_assert(sizeof(OrderEvent) == 32, "OrderEvent must stay 32 bytes");
+static_assert(std::is_trivially_copyable_v<OrderEvent>,
+              "OrderEvent must be trivially copyable for ring buffer");
+
 // ═══════════════════════════════════════════════════════════════════════
-//  8. INTRUSIVE ORDER LIST — Zero-Allocation FIFO Linked List
+//  11. INTRUSIVE ORDER LIST — Zero-Allocation FIFO Linked List
 // ═══════════════════════════════════════════════════════════════════════
 
-/// Singly-linked intrusive list for Order nodes.
-/// The `next` pointer lives inside Order itself (no external allocation).
+/// Doubly-linked intrusive list for Order nodes.
+/// The `next`/`prev` pointers live inside Order itself (no external
+/// allocation), and Order still fits one cache line.
 ///
 /// Design:
 ///   - push_back: O(1), sets tail->next = node, advances tail. ZERO alloc.
+///   - unlink:    O(1), removes any node in place (cancel never leaves a
+///   dead node for matching to walk over).
 ///   - match:     O(K), walks from head, fills orders FIFO.
 ///   - compact:   O(N), unlinks inactive nodes (periodic, not hot path).
+///   - prune_front: bounded compact for dead heads, safe on any poll.
+///   - Unlinked dead nodes can be handed to a second list (the graveyard)
+///   and returned to the ObjectPool later, in bounded batches.
 ///   - All nodes come from ObjectPool — no new/delete, no malloc.
 ///
 /// This replaces std::vector<Order*> to eliminate hidden reallocation
@@ -468,6 +1246,7 @@ public:
   /// Append an order to the tail. O(1), zero allocation.
   void push_back(Order *order) noexcept {
     order->next = nullptr;
+    order->prev = tail_;
     if (tail_) {
       tail_->next = order;
     } else {
@@ -499,29 +1278,90 @@ public:
     return filled;
   }
 
-  /// Unlink inactive/filled nodes from the list (periodic cleanup).
-  /// O(N) where N = list length. NOT on the hot path.
-  void compact() noexcept {
-    Order *prev = nullptr;
-    Order *current = head_;
-
+  /// Detach and return the head node, or nullptr if empty. O(1).
+  [[nodiscard]] Order *pop_front() noexcept {
+    Order *node = head_;
+    if (!node)
+      return nullptr;
+    head_ = node->next;
+    if (head_)
+      head_->prev = nullptr;
+    else
+      tail_ = nullptr;
+    node->next = nullptr;
+    --count_;
+    return node;
+  }
+
+  /// Remove `node` (which must be on this list) in place. O(1).
+  void unlink(Order *node) noexcept {
+    if (node->prev)
+      node->prev->next = node->next;
+    else
+      head_ = node->next;
+    if (node->next)
+      node->next->prev = node->prev;
+    else
+      tail_ = node->prev;
+    node->next = node->prev = nullptr;
+    --count_;
+  }
+
+  /// First live order, or nullptr. Dead nodes ahead of it are unlinked on
+  /// the way (into `dead` if given), so each one is skipped at most once.
+  /// O(1) amortized.
+  [[nodiscard]] Order *front_live(IntrusiveOrderList *dead = nullptr) noexcept {
+    while (head_ && (!head_->active || head_->remaining_qty == 0)) {
+      Order *node = pop_front();
+      if (dead)
+        dead->push_back(node);
+    }
+    return head_;
+  }
+
+  /// Unlink at most `budget` dead nodes from the front (into `dead` if
+  /// given). Returns how many were unlinked. O(budget).
+  std::size_t prune_front(IntrusiveOrderList *dead,
+                          std::size_t budget) noexcept {
+    std::size_t pruned = 0;
+    while (pruned < budget && head_ &&
+           (!head_->active || head_->remaining_qty == 0)) {
+      Order *node = pop_front();
+      if (dead)
+        dead->push_back(node);
+      ++pruned;
+    }
+    return pruned;
+  }
+
+  /// Move every node to the tail of `dead` (nullptr: just drop them) and
+  /// leave this list empty. O(1): the chain is spliced, not walked.
+  void drain_into(IntrusiveOrderList *dead) noexcept {
+    if (dead && head_) {
+      head_->prev = dead->tail_;
+      if (dead->tail_)
+        dead->tail_->next = head_;
+      else
+        dead->head_ = head_;
+      dead->tail_ = tail_;
+      dead->count_ += count_;
+    }
+    head_ = tail_ = nullptr;
+    count_ = 0;
+  }
+
+  /// Unlink inactive/filled nodes from the list (periodic cleanup), handing
+  /// them to `dead` if given. O(N) where N = list length. NOT on the hot path.
+  void compact(IntrusiveOrderList *dead = nullptr) noexcept {
+    Order *current = head_;
+
     while (current) {
       Order *next_node = current->next;
 
       if (!current->active || current->remaining_qty == 0) {
-        // Unlink this node
-        if (prev) {
-          prev->next = next_node;
-        } else {
-          head_ = next_node;
-        }
-        if (current == tail_) {
-          tail_ = prev;
-        }
-        current->next = nullptr;
-        --count_;
-      } else {
-        prev = current;
+        unlink(current);
+        if (dead)
+          dead->push_back(current);
       }
       current = next_node;
     }
@@ -532,6 +1372,7 @@ public:
   [[nodiscard]] bool empty() const noexcept { return head_ == nullptr; }
   [[nodiscard]] std::size_t size() const noexcept { return count_; }
   [[nodiscard]] Order *head() const noexcept { return head_; }
+  [[nodiscard]] Order *tail() const noexcept { return tail_; }
 
 private:
   Order *head_ = nullptr;
@@ -540,12 +1381,15 @@ private:
 };
 
 // ═══════════════════════════════════════════════════════════════════════
-//  9. PRICE LEVEL — Intrusive list of orders at one price point
+//  12. PRICE LEVEL — Intrusive list of orders at one price point
 // ═══════════════════════════════════════════════════════════════════════
 
 /// Orders at a single price level maintained as an intrusive linked list.
-/// Orders are FIFO (price-time priority). Cancellation sets remaining_qty=0
-/// (lazy delete — avoids list surgery on hot path).
+/// Orders are FIFO (price-time priority). Cancellation unlinks the order in
+/// O(1); filled orders are unlinked lazily as matching moves past them.
+/// Only displayed quantity counts: an iceberg contributes its current slice,
+/// and when the slice fills the next one comes out of its reserve, behind
+/// everyone already queued.
 ///
 /// Key invariant: add_order is ALWAYS O(1) with ZERO heap allocation,
 /// regardless of how many orders are at this price level.
@@ -553,10 +1397,16 @@ private:
 /// Complexity: add O(1) guaranteed, match O(K) where K = fills per level
 class PriceLevel {
 public:
+  /// pending_delta() of a level with no delta queued.
+  static constexpr uint32_t NOT_PENDING = ~uint32_t{0};
+
   PriceLevel() = default;
 
   explicit PriceLevel(int64_t price) : price_(price) {}
 
+  /// Reassign an empty ring slot to a new price (window re-centering).
+  void reprice(int64_t price) noexcept { price_ = price; }
+
   // ─────────── API ───────────
 
   void add_order(Order *order) noexcept {
@@ -564,14 +1414,66 @@ public:
     cached_qty_ += order->remaining_qty;
   }
 
-  /// Match against this level up to `qty` units.
+  /// Match against this level up to `qty` units, head first, through fill()
+  /// so icebergs refill. Filled heads are unlinked (into `dead` if given).
   /// Returns total quantity filled at this level.
-  uint32_t match(uint32_t qty) noexcept {
-    uint32_t filled = orders_.match(qty);
-    cached_qty_ -= filled;
+  uint32_t match(uint32_t qty, IntrusiveOrderList *dead = nullptr) noexcept {
+    uint32_t filled = 0;
+    while (filled < qty) {
+      Order *head = orders_.front_live(dead);
+      if (!head)
+        break;
+      uint32_t fill_qty = std::min(head->remaining_qty, qty - filled);
+      fill(head, fill_qty);
+      filled += fill_qty;
+    }
     return filled;
   }
 
+  /// Oldest live order at this level (FIFO head), or nullptr. Dead nodes
+  /// in front of it move to `dead`.
+  [[nodiscard]] Order *front(IntrusiveOrderList *dead = nullptr) noexcept {
+    return orders_.front_live(dead);
+  }
+
+  /// Move at most `budget` dead heads to `dead`. Returns how many moved.
+  std::size_t prune(IntrusiveOrderList *dead, std::size_t budget) noexcept {
+    return orders_.prune_front(dead, budget);
+  }
+
+  /// Hand every node to `dead`. Only valid once total_qty() == 0, i.e. when
+  /// no node on the level is live any more. O(1).
+  void drain_into(IntrusiveOrderList *dead) noexcept {
+    orders_.drain_into(dead);
+  }
+
+  /// Fill `qty` units of a live order resting at this level. An iceberg
+  /// whose slice runs out shows the next one and moves to the tail in O(1),
+  /// the same Order with no pool traffic. Returns true in that case.
+  bool fill(Order *order, uint32_t qty) noexcept {
+    order->remaining_qty -= qty;
+    cached_qty_ -= qty;
+    if (order->remaining_qty > 0)
+      return false;
+    if (order->hidden_qty == 0) {
+      order->active = 0;
+      return false;
+    }
+    uint32_t slice = std::min(order->peak_qty, order->hidden_qty);
+    order->hidden_qty -= slice;
+    order->remaining_qty = slice;
+    cached_qty_ += slice;
+    orders_.unlink(order);
+    orders_.push_back(order);
+    return true;
+  }
+
+  /// Unlink a cancelled order carrying `qty` live units. O(1).
+  void remove(Order *order, uint32_t qty) noexcept {
+    orders_.unlink(order);
+    reduce_qty(qty);
+  }
+
   /// Decrement cached quantity (for external cancellation).
   void reduce_qty(uint32_t amount) noexcept {
     if (amount <= cached_qty_)
@@ -581,7 +1483,9 @@ public:
   }
 
   /// Remove fully filled/cancelled orders (periodic cleanup, not on hot path).
-  void compact() noexcept { orders_.compact(); }
+  void compact(IntrusiveOrderList *dead = nullptr) noexcept {
+    orders_.compact(dead);
+  }
 
   // ─────────── Accessors ───────────
 
@@ -591,267 +1495,2611 @@ public:
   [[nodiscard]] std::size_t order_count() const noexcept {
     return orders_.size();
   }
+  /// First and last node in queue order, dead ones included (for policies
+  /// that walk the whole level).
+  [[nodiscard]] Order *head() const noexcept { return orders_.head(); }
+  [[nodiscard]] Order *back() const noexcept { return orders_.tail(); }
+
+  /// Slot of this level in a MarketDataSink's pending batch, or NOT_PENDING.
+  /// Kept here so marking a level dirty twice in one message is one load.
+  [[nodiscard]] uint32_t pending_delta() const noexcept {
+    return pending_delta_;
+  }
+  void set_pending_delta(uint32_t slot) noexcept { pending_delta_ = slot; }
 
 private:
   int64_t price_ = 0;
   uint32_t cached_qty_ = 0; // O(1) total quantity tracking
+  uint32_t pending_delta_ = NOT_PENDING; // fills the padding after cached_qty_
   IntrusiveOrderList orders_;
 };
 
 // ═══════════════════════════════════════════════════════════════════════
-//  10. ORDER BOOK — Bid/Ask with Price-Time Matching
+//  13. OCCUPANCY BITMAP — Hierarchical bitset of non-empty levels
 // ═══════════════════════════════════════════════════════════════════════
 
-/// Cache-friendly order book with flat vector price levels.
+/// Three-level bitset over N slots answering "next/previous set slot" with a
+/// handful of tzcnt/lzcnt instructions, independent of the distance between
+/// set slots.
 ///
 /// Design:
-///   - Bids and asks stored as vectors of PriceLevel, indexed by normalized
-///   price
-///   - Price normalization: index = (price - base_price) mapped to [0,
-///   MAX_PRICE_LEVELS)
-///   - Order ID -> Order* lookup via flat array (O(1) cancel)
-///   - Matching: walk best bid vs best ask, fill at aggressor price
+///   - l0_: one bit per slot
+///   - l1_: bit j set  <=>  l0_[j] != 0
+///   - l2_: bit k set  <=>  l1_[k] != 0   (single word: N <= 64^3 = 262144)
+///   - set/clear touch at most one word per level; clear stops climbing as
+///   soon as a word stays non-zero
+///   - Queries return N when no slot qualifies
 ///
-/// Complexity:
-///   add_order: O(1) guaranteed (index + intrusive list push_back, ZERO alloc)
-///   cancel:    O(1) (lookup + set inactive)
-///   match:     O(L * K) where L = crossing levels, K = orders per level
-class OrderBook {
-public:
-  OrderBook() {
-    bid_levels_.resize(config::MAX_PRICE_LEVELS);
-    ask_levels_.resize(config::MAX_PRICE_LEVELS);
+/// Complexity: set O(1), clear O(1), find_next/find_prev O(1) (<= 3 words)
+template <std::size_t N> class OccupancyBitmap {
+  static_assert(N > 0 && N <= 64 * 64 * 64,
+                "OccupancyBitmap covers at most 262144 slots");
 
-    // Initialize price levels with their prices
-    for (std::size_t i = 0; i < config::MAX_PRICE_LEVELS; ++i) {
-      auto price = static_cast<int64_t>(i) * config::PRICE_MULTIPLIER / 100;
-      bid_levels_[i] = PriceLevel(price);
-      ask_levels_[i] = PriceLevel(price);
-    }
+public:
+  static constexpr std::size_t NONE = N;
 
-    // Order ID map: heap-allocated flat array for O(1) lookup
-    // Allocated once at construction (not on hot path)
-    id_map_.resize(config::ORDER_ID_MAP_SIZE, nullptr);
+  void set(std::size_t i) noexcept {
+    l0_[i >> 6] |= bit(i & 63);
+    l1_[i >> 12] |= bit((i >> 6) & 63);
+    l2_ |= bit(i >> 12);
   }
 
-  // ─────────── API ───────────
-
-  /// Add a limit order to the book.
-  void add_order(Order *order) {
-    std::size_t level_idx = price_to_index(order->price);
-    if (level_idx >= config::MAX_PRICE_LEVELS) [[unlikely]]
+  void clear(std::size_t i) noexcept {
+    if ((l0_[i >> 6] &= ~bit(i & 63)) != 0)
+      return;
+    if ((l1_[i >> 12] &= ~bit((i >> 6) & 63)) != 0)
       return;
+    l2_ &= ~bit(i >> 12);
+  }
 
-    order->active = 1;
+  [[nodiscard]] bool test(std::size_t i) const noexcept {
+    return (l0_[i >> 6] & bit(i & 63)) != 0;
+  }
 
-    // Register in ID map for O(1) cancel
-    auto map_idx = order->id & (config::ORDER_ID_MAP_SIZE - 1);
-    id_map_[map_idx] = order;
+  [[nodiscard]] bool any() const noexcept { return l2_ != 0; }
+
+  /// Lowest set slot >= from, or NONE.
+  [[nodiscard]] std::size_t find_next(std::size_t from) const noexcept {
+    if (from >= N) [[unlikely]]
+      return NONE;
+
+    std::size_t w0 = from >> 6;
+    uint64_t bits = l0_[w0] & (~uint64_t{0} << (from & 63));
+    if (bits)
+      return (w0 << 6) + std::countr_zero(bits);
+
+    std::size_t w1 = w0 >> 6;
+    bits = l1_[w1] & above(w0 & 63);
+    if (!bits) {
+      uint64_t top = l2_ & above(w1);
+      if (!top)
+        return NONE;
+      w1 = std::countr_zero(top);
+      bits = l1_[w1];
+    }
+    w0 = (w1 << 6) + std::countr_zero(bits);
+    return (w0 << 6) + std::countr_zero(l0_[w0]);
+  }
 
-    if (order->side == Side::BID) {
-      bid_levels_[level_idx].add_order(order);
-      if (level_idx > best_bid_idx_)
-        best_bid_idx_ = level_idx;
-    } else {
-      ask_levels_[level_idx].add_order(order);
-      if (best_ask_idx_ == 0 || level_idx < best_ask_idx_) {
-        best_ask_idx_ = level_idx;
-      }
+  /// Highest set slot <= from (clamped to N - 1), or NONE.
+  [[nodiscard]] std::size_t find_prev(std::size_t from) const noexcept {
+    if (from >= N)
+      from = N - 1;
+
+    std::size_t w0 = from >> 6;
+    uint64_t bits = l0_[w0] & upto(from & 63);
+    if (bits)
+      return (w0 << 6) + highest(bits);
+
+    std::size_t w1 = w0 >> 6;
+    bits = l1_[w1] & below(w0 & 63);
+    if (!bits) {
+      uint64_t top = l2_ & below(w1);
+      if (!top)
+        return NONE;
+      w1 = highest(top);
+      bits = l1_[w1];
     }
+    w0 = (w1 << 6) + highest(bits);
+    return (w0 << 6) + highest(l0_[w0]);
   }
 
-  /// Cancel an order by ID. O(1).
-  /// Updates PriceLevel cached_qty_ to prevent stale-quantity infinite loops.
-  bool cancel_order(uint64_t order_id) {
-    auto map_idx = order_id & (config::ORDER_ID_MAP_SIZE - 1);
-    Order *order = id_map_[map_idx];
+private:
+  static constexpr std::size_t L0_WORDS = (N + 63) / 64;
+  static constexpr std::size_t L1_WORDS = (L0_WORDS + 63) / 64;
 
-    if (!order || order->id != order_id || !order->active) {
-      return false;
+  [[nodiscard]] static constexpr uint64_t bit(std::size_t i) noexcept {
+    return uint64_t{1} << i;
+  }
+  /// Bits strictly above / strictly below / up to and including position k.
+  [[nodiscard]] static constexpr uint64_t above(std::size_t k) noexcept {
+    return (k == 63) ? 0 : (~uint64_t{0} << (k + 1));
+  }
+  [[nodiscard]] static constexpr uint64_t below(std::size_t k) noexcept {
+    return bit(k) - 1;
+  }
+  [[nodiscard]] static constexpr uint64_t upto(std::size_t k) noexcept {
+    return (k == 63) ? ~uint64_t{0} : (bit(k + 1) - 1);
+  }
+  [[nodiscard]] static std::size_t highest(uint64_t bits) noexcept {
+    return 63 - static_cast<std::size_t>(std::countl_zero(bits));
+  }
+
+  std::array<uint64_t, L0_WORDS> l0_{};
+  std::array<uint64_t, L1_WORDS> l1_{};
+  uint64_t l2_ = 0;
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+//  14. ORDER ID MAP — Robin Hood order ID -> Order* index
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Order ID -> Order* index: open addressing with Robin Hood displacement.
+///
+/// One map is shared by every book on a matcher: order IDs are unique per
+/// gateway, and a table per instrument would dwarf the books themselves.
+/// A standalone OrderBook owns a private map instead.
+///
+/// Design:
+///   - Sized once for the most orders that can be mapped at a time (the
+///   pool's capacity): a power-of-2 table at most 3/4 full, 16 bytes per slot.
+///   Memory follows the pool, not the order ID space
+///   - Every live ID has its own entry, so two orders never overwrite each
+///   other the way IDs 2^20 apart did in a direct-mapped table
+///   - Robin Hood insert keeps displacements short and even; erase shifts the
+///   run back one slot, so there are no tombstones and churn never lengthens
+///   probes
+///   - Hard bound: no entry sits more than ORDER_ID_MAX_PROBE slots past its
+///   home. An insert that would break it is refused, so a lookup never reads
+///   more than ORDER_ID_MAX_PROBE + 1 slots
+///
+/// Complexity: insert/find/erase O(1), lookups bounded by ORDER_ID_MAX_PROBE
+class OrderIdMap {
+public:
+  // Heap-allocated once at construction (not on hot path)
+  explicit OrderIdMap(std::size_t max_live_orders = config::MAX_ORDERS)
+      : mask_(std::bit_ceil(std::max<std::size_t>(
+                  max_live_orders + max_live_orders / 3, 64)) -
+              1),
+        shift_(64 - std::countr_zero(mask_ + 1)), slots_(mask_ + 1) {}
+
+  /// Map `order->id` to `order`. Returns false, leaving the map unchanged, if
+  /// the ID is already mapped or placing it would push some entry more than
+  /// ORDER_ID_MAX_PROBE slots from home.
+  [[nodiscard]] bool insert(Order *order) noexcept {
+    uint64_t order_id = order->id;
+    std::size_t pos = home_of(order_id);
+    std::size_t dist = 0;
+
+    // Walk to the first slot whose entry is closer to home than we are
+    for (;; pos = next(pos), ++dist) {
+      const Slot &slot = slots_[pos];
+      if (!slot.order || displacement(slot, pos) < dist)
+        break;
+      if (slot.id == order_id) [[unlikely]]
+        return false;
     }
+    if (dist > config::ORDER_ID_MAX_PROBE) [[unlikely]]
+      return false;
 
-    // Update cached quantity on the correct price level BEFORE zeroing
-    std::size_t level_idx = price_to_index(order->price);
-    if (level_idx < config::MAX_PRICE_LEVELS) {
-      if (order->side == Side::BID) {
-        bid_levels_[level_idx].reduce_qty(order->remaining_qty);
-      } else {
-        ask_levels_[level_idx].reduce_qty(order->remaining_qty);
-      }
+    // Every entry up to the next hole moves one slot further from home
+    std::size_t hole = pos;
+    for (; slots_[hole].order; hole = next(hole)) {
+      if (displacement(slots_[hole], hole) == config::ORDER_ID_MAX_PROBE)
+          [[unlikely]]
+        return false;
     }
+    for (; hole != pos; hole = prev(hole))
+      slots_[hole] = slots_[prev(hole)];
 
-    order->active = 0;
-    order->remaining_qty = 0;
-    id_map_[map_idx] = nullptr;
-    ++cancel_count_;
+    slots_[pos] = Slot{order_id, order};
+    ++size_;
     return true;
   }
 
-  /// Match crossing orders (bid >= ask). Returns total filled quantity.
-  uint64_t match() {
-    uint64_t total_filled = 0;
+  [[nodiscard]] Order *find(uint64_t order_id) const noexcept {
+    std::size_t pos = locate(order_id);
+    return pos != NOT_FOUND ? slots_[pos].order : nullptr;
+  }
 
-    while (best_bid_idx_ > 0 && best_ask_idx_ > 0 &&
-           best_bid_idx_ < config::MAX_PRICE_LEVELS &&
-           best_ask_idx_ < config::MAX_PRICE_LEVELS) {
-      auto &bid_level = bid_levels_[best_bid_idx_];
-      auto &ask_level = ask_levels_[best_ask_idx_];
+  void erase(uint64_t order_id) noexcept {
+    std::size_t pos = locate(order_id);
+    if (pos == NOT_FOUND)
+      return;
 
-      // Crossing condition: best bid price >= best ask price
-      if (bid_level.price() < ask_level.price())
-        break;
+    // Backward-shift deletion: pull the rest of the run one slot home
+    for (std::size_t after = next(pos);
+         slots_[after].order && displacement(slots_[after], after) > 0;
+         after = next(after)) {
+      slots_[pos] = slots_[after];
+      pos = after;
+    }
+    slots_[pos] = Slot{};
+    --size_;
+  }
 
-      uint32_t bid_qty = bid_level.total_qty();
-      uint32_t ask_qty = ask_level.total_qty();
+  // ─────────── Accessors ───────────
 
-      if (bid_qty == 0) {
-        // No active bids at this level, move down
-        if (best_bid_idx_ > 0)
-          --best_bid_idx_;
-        else
-          break;
-        continue;
-      }
-      if (ask_qty == 0) {
-        // No active asks at this level, move up
-        ++best_ask_idx_;
-        continue;
-      }
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+  [[nodiscard]] std::size_t slot_count() const noexcept { return mask_ + 1; }
 
-      // Match: fill the smaller side
-      uint32_t match_qty = std::min(bid_qty, ask_qty);
-      bid_level.match(match_qty);
-      ask_level.match(match_qty);
+  /// Largest distance of any entry from its home slot. O(slots), cold path.
+  [[nodiscard]] std::size_t max_displacement() const noexcept {
+    std::size_t worst = 0;
+    for (std::size_t pos = 0; pos <= mask_; ++pos) {
+      if (slots_[pos].order)
+        worst = std::max(worst, displacement(slots_[pos], pos));
+    }
+    return worst;
+  }
 
-      total_filled += match_qty;
-      ++match_count_;
+private:
+  struct Slot {
+    uint64_t id = 0;
+    Order *order = nullptr; // nullptr = empty slot
+  };
 
-      // Update best levels if exhausted
-      if (bid_level.total_qty() == 0 && best_bid_idx_ > 0)
-        --best_bid_idx_;
-      if (ask_level.total_qty() == 0)
-        ++best_ask_idx_;
+  static constexpr std::size_t NOT_FOUND = ~std::size_t{0};
+
+  /// Slot holding `order_id`, or NOT_FOUND. Stops at the first entry closer
+  /// to its home than the probe is, and never looks past ORDER_ID_MAX_PROBE.
+  [[nodiscard]] std::size_t locate(uint64_t order_id) const noexcept {
+    std::size_t pos = home_of(order_id);
+    for (std::size_t dist = 0; dist <= config::ORDER_ID_MAX_PROBE;
+         ++dist, pos = next(pos)) {
+      const Slot &slot = slots_[pos];
+      if (!slot.order || displacement(slot, pos) < dist)
+        return NOT_FOUND;
+      if (slot.id == order_id)
+        return pos;
     }
+    return NOT_FOUND;
+  }
 
-    return total_filled;
+  /// Fibonacci hashing: sequential and strided IDs spread over the table.
+  [[nodiscard]] std::size_t home_of(uint64_t order_id) const noexcept {
+    return static_cast<std::size_t>((order_id * 0x9E3779B97F4A7C15ULL) >>
+                                    shift_);
+  }
+  [[nodiscard]] std::size_t displacement(const Slot &slot,
+                                         std::size_t pos) const noexcept {
+    return (pos - home_of(slot.id)) & mask_;
+  }
+  [[nodiscard]] std::size_t next(std::size_t pos) const noexcept {
+    return (pos + 1) & mask_;
+  }
+  [[nodiscard]] std::size_t prev(std::size_t pos) const noexcept {
+    return (pos - 1) & mask_;
   }
 
-  /// Match a market order immediately against the book.
-  uint64_t match_market(Order *order) {
-    uint64_t filled = 0;
+  std::size_t mask_;
+  int shift_;
+  std::size_t size_ = 0;
+  std::vector<Slot> slots_;
+};
 
-    if (order->side == Side::BID) {
-      // Market buy: match against asks (ascending)
-      for (std::size_t i = best_ask_idx_; i < config::MAX_PRICE_LEVELS; ++i) {
-        if (order->remaining_qty == 0)
-          break;
-        uint32_t fill = ask_levels_[i].match(order->remaining_qty);
-        order->remaining_qty -= fill;
-        filled += fill;
-        if (ask_levels_[i].total_qty() == 0 && i == best_ask_idx_) {
-          ++best_ask_idx_;
-        }
-      }
-    } else {
-      // Market sell: match against bids (descending)
-      for (std::size_t i = best_bid_idx_; i < config::MAX_PRICE_LEVELS; --i) {
-        if (order->remaining_qty == 0)
-          break;
-        uint32_t fill = bid_levels_[i].match(order->remaining_qty);
-        order->remaining_qty -= fill;
-        filled += fill;
-        if (bid_levels_[i].total_qty() == 0 && i == best_bid_idx_) {
-          if (best_bid_idx_ > 0)
-            --best_bid_idx_;
-          else
-            break;
-        }
-        if (i == 0)
-          break;
-      }
-    }
+// ═══════════════════════════════════════════════════════════════════════
+//  15. OWNER INDEX — Per-session chains through orders, for mass cancel
+// ═══════════════════════════════════════════════════════════════════════
 
-    if (filled > 0)
-      ++match_count_;
-    return filled;
+/// Per-owner (session) chains through the orders each owner has in the
+/// books, so a disconnect cancels them all without touching anyone else's.
+///
+/// Design:
+///   - Order carries only its 16-bit owner_id. The links live in a side
+///   array parallel to the order pool's storage, indexed by pool slot, so
+///   Order stays one cache line
+///   - Doubly-linked through 32-bit slot indices: link and unlink are O(1)
+///   - An order joins its chain when a book admits it and leaves when its
+///   slot is reclaimed, so a chain also holds the owner's dead orders still
+///   waiting in the graveyard (bounded by the reclaim backlog)
+///   - owner_id 0, owners >= MAX_OWNERS and orders outside the attached pool
+///   are simply not chained
+///
+/// Complexity: link/unlink O(1), for_each O(chain length)
+class OwnerIndex {
+public:
+  /// Chain orders from the pool whose storage is [base, base + count).
+  /// Until then nothing is tracked. NOT on the hot path.
+  void attach(Order *base, std::size_t count) {
+    base_ = base;
+    links_.assign(count, Link{});
+    heads_.assign(config::MAX_OWNERS, NIL);
   }
 
-  // ─────────── Stats ───────────
+  void link(const Order *order) noexcept {
+    if (!tracks(order))
+      return;
+    uint32_t slot = slot_of(order);
+    uint32_t &head = heads_[order->owner_id];
+    links_[slot] = Link{NIL, head};
+    if (head != NIL)
+      links_[head].prev = slot;
+    head = slot;
+  }
 
-  [[nodiscard]] uint64_t match_count() const noexcept { return match_count_; }
-  [[nodiscard]] uint64_t cancel_count() const noexcept { return cancel_count_; }
+  /// Drop `order` from its chain; a no-op if it was never linked.
+  void unlink(const Order *order) noexcept {
+    if (!tracks(order))
+      return;
+    uint32_t slot = slot_of(order);
+    Link &node = links_[slot];
+    if (node.prev == UNLINKED)
+      return;
+    if (node.prev != NIL)
+      links_[node.prev].next = node.next;
+    else
+      heads_[order->owner_id] = node.next;
+    if (node.next != NIL)
+      links_[node.next].prev = node.prev;
+    node = Link{};
+  }
 
-  [[nodiscard]] int64_t best_bid_price() const noexcept {
-    if (best_bid_idx_ < config::MAX_PRICE_LEVELS) {
-      return bid_levels_[best_bid_idx_].price();
+  /// Call `fn(Order *)` for every order on `owner_id`'s chain, newest
+  /// first. `fn` may cancel the order but must not reclaim it.
+  template <typename Fn> void for_each(uint32_t owner_id, Fn &&fn) const {
+    if (owner_id == 0 || owner_id >= heads_.size())
+      return;
+    for (uint32_t slot = heads_[owner_id]; slot != NIL;) {
+      uint32_t next = links_[slot].next;
+      fn(base_ + slot);
+      slot = next;
     }
-    return 0;
   }
 
-  [[nodiscard]] int64_t best_ask_price() const noexcept {
-    if (best_ask_idx_ < config::MAX_PRICE_LEVELS) {
-      return ask_levels_[best_ask_idx_].price();
+private:
+  static constexpr uint32_t NIL = 0xFFFFFFFF;      // no neighbour / empty
+  static constexpr uint32_t UNLINKED = 0xFFFFFFFE; // slot not on any chain
+
+  struct Link {
+    uint32_t prev = UNLINKED;
+    uint32_t next = NIL;
+  };
+
+  [[nodiscard]] bool tracks(const Order *order) const noexcept {
+    return order->owner_id != 0 && order->owner_id < heads_.size() &&
+           order >= base_ && order < base_ + links_.size();
+  }
+  [[nodiscard]] uint32_t slot_of(const Order *order) const noexcept {
+    return static_cast<uint32_t>(order - base_);
+  }
+
+  Order *base_ = nullptr;
+  std::vector<Link> links_;     // one per pool slot
+  std::vector<uint32_t> heads_; // owner_id -> newest slot on its chain
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+//  16. EXECUTION SINK — Outbound per-fill report stream
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Producer end of a matcher's outbound ExecutionReport ring.
+///
+/// Design:
+///   - Books hold a non-owning pointer; nullptr means nobody listens and the
+///   book skips building reports entirely
+///   - Reports are copied into pre-allocated ring slots: ZERO heap alloc
+///   - Back-pressure: a full ring makes the matcher spin until the consumer
+///   frees a slot. Fills are never dropped; each failed push is counted
+class ExecutionSink {
+public:
+  ExecutionSink(LockFreeRingBuffer<ExecutionReport> &ring,
+                std::atomic<uint64_t> &stall_counter) noexcept
+      : ring_(ring), stalls_(stall_counter) {}
+
+  void publish(const ExecutionReport &report) noexcept {
+    while (!ring_.push(report)) [[unlikely]] {
+      stalls_.fetch_add(1, std::memory_order_relaxed);
     }
-    return 0;
   }
 
 private:
-  /// Convert fixed-point price to level index.
-  [[nodiscard]] static std::size_t price_to_index(int64_t price) noexcept {
-    // Normalize: price / (PRICE_MULTIPLIER/100) gives index
-    auto idx = static_cast<std::size_t>(price * 100 / config::PRICE_MULTIPLIER);
-    return std::min(idx, config::MAX_PRICE_LEVELS - 1);
+  LockFreeRingBuffer<ExecutionReport> &ring_;
+  std::atomic<uint64_t> &stalls_;
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+//  17. MARKET DATA SINK — Coalesced L2 level deltas, one batch per message
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Producer end of a matcher's outbound LevelDelta ring (incremental L2
+/// feed).
+///
+/// Design:
+///   - Books call touch() at every point where a level's displayed quantity
+///   changes (rest, fill, cancel, amend, uncross); nullptr means no feed and
+///   the book skips it entirely
+///   - touch() only marks the level dirty: a level touched again in the same
+///   message is found through PriceLevel::pending_delta() in O(1), so a
+///   taker sweeping 50 makers at one price yields one delta, not 50
+///   - flush() runs once per processed message and publishes the final
+///   quantity of each dirty level, in first-touch order. A level repriced by
+///   a window re-centering since its touch has quantity 0 at the old price
+///   - Never stalls the matcher: a full ring drops the delta and counts it.
+///   Sequence numbers are assigned before the push, so a consumer sees the
+///   loss as a gap and can resynchronise from a snapshot
+///   - A message dirtying more than MARKET_DATA_BATCH levels (mass cancel)
+///   flushes early; the batch is a fixed array, ZERO heap alloc
+///
+/// Complexity: touch O(1), flush O(levels dirtied by the message)
+class MarketDataSink {
+public:
+  MarketDataSink(LockFreeRingBuffer<LevelDelta> &ring,
+                 std::atomic<uint64_t> &drop_counter) noexcept
+      : ring_(ring), drops_(drop_counter) {}
+
+  MarketDataSink(const MarketDataSink &) = delete;
+  MarketDataSink &operator=(const MarketDataSink &) = delete;
+
+  /// Mark `level` of `side` dirty. Call after its quantity has changed; the
+  /// level must stay alive until the next flush().
+  void touch(PriceLevel &level, uint16_t instrument_id, Side side) noexcept {
+    uint32_t slot = level.pending_delta();
+    if (slot != PriceLevel::NOT_PENDING &&
+        pending_[slot].price == level.price())
+      return;
+    if (count_ == pending_.size()) [[unlikely]]
+      flush();
+    level.set_pending_delta(static_cast<uint32_t>(count_));
+    pending_[count_++] = Pending{&level, level.price(), instrument_id, side};
   }
 
-  std::vector<PriceLevel> bid_levels_;
-  std::vector<PriceLevel> ask_levels_;
+  /// Publish one delta per dirty level and start a new batch.
+  void flush() noexcept {
+    for (std::size_t i = 0; i < count_; ++i) {
+      const Pending &dirty = pending_[i];
+      dirty.level->set_pending_delta(PriceLevel::NOT_PENDING);
+
+      LevelDelta delta;
+      delta.sequence = ++sequence_;
+      delta.price = dirty.price;
+      delta.quantity =
+          dirty.level->price() == dirty.price ? dirty.level->total_qty() : 0;
+      delta.instrument_id = dirty.instrument_id;
+      delta.side = dirty.side;
+      if (!ring_.push(delta)) [[unlikely]]
+        drops_.fetch_add(1, std::memory_order_relaxed);
+    }
+    count_ = 0;
+  }
 
-  // Flat O(1) order ID -> Order* map (heap-allocated once, not on hot path)
-  std::vector<Order *> id_map_;
+  /// Deltas sequenced so far (published or dropped) = last sequence number.
+  [[nodiscard]] uint64_t sequence() const noexcept { return sequence_; }
+  /// Levels dirtied since the last flush().
+  [[nodiscard]] std::size_t pending() const noexcept { return count_; }
 
-  std::size_t best_bid_idx_ = 0;
-  std::size_t best_ask_idx_ = 0;
+private:
+  struct Pending {
+    PriceLevel *level;
+    int64_t price; // level price at the first touch
+    uint16_t instrument_id;
+    Side side;
+  };
 
-  uint64_t match_count_ = 0;
-  uint64_t cancel_count_ = 0;
+  LockFreeRingBuffer<LevelDelta> &ring_;
+  std::atomic<uint64_t> &drops_;
+  uint64_t sequence_ = 0;
+  std::size_t count_ = 0;
+  std::array<Pending, config::MARKET_DATA_BATCH> pending_;
 };
 
 // ═══════════════════════════════════════════════════════════════════════
-//  10. CPU PINNING — Platform-specific thread affinity
+//  18. ORDER FEED SINK — L3 order-by-order events out of the books
 // ═══════════════════════════════════════════════════════════════════════
 
-namespace platform {
+/// Producer end of a matcher's outbound OrderEvent ring (L3 feed).
+///
+/// Design:
+///   - Books call publish() at the points where a single order changes on
+///   the book: rest, in-place amend, cancel and each per-maker fill. nullptr
+///   means no feed and the book skips building events entirely
+///   - Events are fixed 32-byte records copied into pre-allocated ring
+///   slots: ZERO heap alloc, no coalescing (each event is a queue change)
+///   - Never stalls the matcher: like MarketDataSink, a full ring drops the
+///   event and counts it, and the consumer sees the gap in `sequence`
+///
+/// Complexity: publish O(1)
+class OrderFeedSink {
+public:
+  OrderFeedSink(LockFreeRingBuffer<OrderEvent> &ring,
+                std::atomic<uint64_t> &drop_counter) noexcept
+      : ring_(ring), drops_(drop_counter) {}
+
+  OrderFeedSink(const OrderFeedSink &) = delete;
+  OrderFeedSink &operator=(const OrderFeedSink &) = delete;
+
+  void publish(OrderEventType type, const Order &order,
+               uint32_t qty) noexcept {
+    OrderEvent event;
+    event.sequence = ++sequence_;
+    event.order_id = order.id;
+    event.price = order.price;
+    event.quantity = qty;
+    event.instrument_id = order.instrument_id;
+    event.side = order.side;
+    event.type = type;
+    if (!ring_.push(event)) [[unlikely]]
+      drops_.fetch_add(1, std::memory_order_relaxed);
+  }
 
-/// Pin the calling thread to a specific CPU core.
-/// Prevents context switches and ensures cache locality.
-inline bool pin_thread_to_core(int core_id) {
-#ifdef _WIN32
-  DWORD_PTR mask = static_cast<DWORD_PTR>(1) << core_id;
-  HANDLE thread = GetCurrentThread();
-  DWORD_PTR prev = SetThreadAffinityMask(thread, mask);
-  return prev != 0;
-#else
-  cpu_set_t cpuset;
-  CPU_ZERO(&cpuset);
-  CPU_SET(core_id, &cpuset);
-  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) ==
-         0;
-#endif
-}
+  /// Events sequenced so far (published or dropped) = last sequence number.
+  [[nodiscard]] uint64_t sequence() const noexcept { return sequence_; }
 
-/// Get current timestamp in nanoseconds (monotonic clock).
-[[nodiscard]] inline uint64_t timestamp_ns() noexcept {
-  auto now = std::chrono::steady_clock::now();
-  return static_cast<uint64_t>(
-      std::chrono::duration_cast<std::chrono::nanoseconds>(
-          now.time_since_epoch())
-          .count());
-}
+private:
+  LockFreeRingBuffer<OrderEvent> &ring_;
+  std::atomic<uint64_t> &drops_;
+  uint64_t sequence_ = 0;
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+//  19. MARKET DATA VIEWS — Seqlock L1 and depth cells, full-depth image
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Level 1 view of one instrument: best prices with their displayed size,
+/// and the last trade.
+struct TopOfBook {
+  int64_t bid_price = 0; // 0 = no bids
+  int64_t ask_price = 0; // 0 = no asks
+  int64_t last_trade_price = 0; // 0 = no trade yet
+  uint32_t bid_qty = 0;
+  uint32_t ask_qty = 0;
+  uint64_t sequence = 0; // updates published before this one was read
+
+  bool operator==(const TopOfBook &) const = default;
+};
+
+/// One instrument's TopOfBook, written by its matcher and read by any
+/// thread (risk, UI, strategies) through a seqlock.
+///
+/// Design:
+///   - One cache line per instrument: readers of one instrument never share
+///   a line with another instrument's writer
+///   - Writer never waits: bump the sequence to odd, store the fields, bump
+///   it to even. No CAS, no lock, two release stores
+///   - Readers copy the fields and retry if the sequence was odd or changed
+///   meanwhile, so they always see one whole snapshot. Reading never writes
+///   the line, so it is not stolen from the matcher until the next update
+///   - Fields are relaxed atomics: a torn read is detected and discarded,
+///   never undefined behaviour
+///
+/// Complexity: publish O(1) wait-free, read O(1) expected (retries only
+/// while an update is in flight)
+class alignas(config::CACHE_LINE_SIZE) TopOfBookCell {
+public:
+  /// Writer side: the book's matcher thread only.
+  void publish(const TopOfBook &top) noexcept {
+    uint64_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bid_price_.store(top.bid_price, std::memory_order_relaxed);
+    ask_price_.store(top.ask_price, std::memory_order_relaxed);
+    last_trade_price_.store(top.last_trade_price, std::memory_order_relaxed);
+    bid_qty_.store(top.bid_qty, std::memory_order_relaxed);
+    ask_qty_.store(top.ask_qty, std::memory_order_relaxed);
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  /// Any thread. Returns a consistent snapshot; `sequence` counts the
+  /// updates published so far (0 = never).
+  [[nodiscard]] TopOfBook read() const noexcept {
+    TopOfBook top;
+    for (;;) {
+      uint64_t before = seq_.load(std::memory_order_acquire);
+      if (before & 1) [[unlikely]] {
+        platform::cpu_relax(); // update in flight
+        continue;
+      }
+      top.bid_price = bid_price_.load(std::memory_order_relaxed);
+      top.ask_price = ask_price_.load(std::memory_order_relaxed);
+      top.last_trade_price = last_trade_price_.load(std::memory_order_relaxed);
+      top.bid_qty = bid_qty_.load(std::memory_order_relaxed);
+      top.ask_qty = ask_qty_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq_.load(std::memory_order_relaxed) == before) [[likely]] {
+        top.sequence = before / 2;
+        return top;
+      }
+    }
+  }
+
+private:
+  std::atomic<uint64_t> seq_{0}; // odd while an update is in flight
+  std::atomic<int64_t> bid_price_{0};
+  std::atomic<int64_t> ask_price_{0};
+  std::atomic<int64_t> last_trade_price_{0};
+  std::atomic<uint32_t> bid_qty_{0};
+  std::atomic<uint32_t> ask_qty_{0};
+};
+
+static_assert(sizeof(TopOfBookCell) == config::CACHE_LINE_SIZE,
+              "TopOfBookCell must be exactly one cache line");
+
+/// One price level of a ConflatedDepth side.
+struct DepthLevel {
+  int64_t price = 0; // 0 = no level at this rank
+  uint32_t qty = 0;
+
+  bool operator==(const DepthLevel &) const = default;
+};
+
+/// Best CONFLATED_DEPTH levels of each side of one instrument, best first,
+/// as the last message that changed them left them.
+struct ConflatedDepth {
+  std::array<DepthLevel, config::CONFLATED_DEPTH> bids{};
+  std::array<DepthLevel, config::CONFLATED_DEPTH> asks{};
+  uint64_t feed_sequence = 0; // last LevelDelta sequence already reflected
+  uint64_t sequence = 0;      // updates published before this one was read
+};
+
+/// Last-value cache of one instrument's ConflatedDepth, written by its
+/// matcher and read by any number of subscribers, however slow.
+///
+/// Design:
+///   - Conflating: each update overwrites the previous one in place. A
+///   subscriber that polls rarely gets the latest state, never a backlog,
+///   and the matcher never waits for it or drops anything on its account
+///   - Same seqlock as TopOfBookCell (sequence odd while the writer is in
+///   the cell, readers retry on a change), over a fixed block of levels:
+///   publish cost is O(CONFLATED_DEPTH) and does not depend on how many
+///   subscribers read the cell, nor how often
+///   - `sequence` counts the updates published to the cell: a subscriber
+///   that last read n and now reads m has had m - n - 1 updates conflated
+///   away. `feed_sequence` tells it where to pick up the L2 delta stream
+///
+/// Complexity: publish O(CONFLATED_DEPTH) wait-free, read O(CONFLATED_DEPTH)
+/// expected
+class alignas(config::CACHE_LINE_SIZE) DepthCacheCell {
+public:
+  /// Writer side: the book's matcher thread only.
+  void publish(const ConflatedDepth &depth) noexcept {
+    uint64_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    feed_sequence_.store(depth.feed_sequence, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < config::CONFLATED_DEPTH; ++i) {
+      bid_price_[i].store(depth.bids[i].price, std::memory_order_relaxed);
+      bid_qty_[i].store(depth.bids[i].qty, std::memory_order_relaxed);
+      ask_price_[i].store(depth.asks[i].price, std::memory_order_relaxed);
+      ask_qty_[i].store(depth.asks[i].qty, std::memory_order_relaxed);
+    }
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  /// Any thread. Returns a consistent image; `sequence` counts the updates
+  /// published so far (0 = never).
+  [[nodiscard]] ConflatedDepth read() const noexcept {
+    ConflatedDepth depth;
+    for (;;) {
+      uint64_t before = seq_.load(std::memory_order_acquire);
+      if (before & 1) [[unlikely]] {
+        platform::cpu_relax(); // update in flight
+        continue;
+      }
+      depth.feed_sequence = feed_sequence_.load(std::memory_order_relaxed);
+      for (std::size_t i = 0; i < config::CONFLATED_DEPTH; ++i) {
+        depth.bids[i].price = bid_price_[i].load(std::memory_order_relaxed);
+        depth.bids[i].qty = bid_qty_[i].load(std::memory_order_relaxed);
+        depth.asks[i].price = ask_price_[i].load(std::memory_order_relaxed);
+        depth.asks[i].qty = ask_qty_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq_.load(std::memory_order_relaxed) == before) [[likely]] {
+        depth.sequence = before / 2;
+        return depth;
+      }
+    }
+  }
+
+private:
+  using Prices = std::array<std::atomic<int64_t>, config::CONFLATED_DEPTH>;
+  using Quantities = std::array<std::atomic<uint32_t>, config::CONFLATED_DEPTH>;
+
+  std::atomic<uint64_t> seq_{0}; // odd while an update is in flight
+  std::atomic<uint64_t> feed_sequence_{0};
+  Prices bid_price_{};
+  Prices ask_price_{};
+  Quantities bid_qty_{};
+  Quantities ask_qty_{};
+};
+
+/// One side of a BookSnapshot: displayed quantity per tick, lowest price
+/// first, from the side's deepest occupied level to its best (bids) or from
+/// its best to its deepest (asks). Ticks with no order inside the range are 0.
+struct DepthImage {
+  int64_t first_price = 0; // price of qty[0]; 0 = empty side
+  std::size_t levels = 0;  // qty[0, levels) is valid
+  std::array<uint32_t, config::PRICE_WINDOW_LEVELS> qty;
+};
+
+/// Full-depth image of one book for recovering or late-joining market-data
+/// clients: replay the L2 deltas sequenced after `sequence` on top of it.
+/// About 32 KB; allocate it once and reuse it.
+struct BookSnapshot {
+  uint64_t sequence = 0; // last LevelDelta sequence already reflected
+  int64_t tick_size = 0; // qty[i] rests at first_price + i * tick_size
+  DepthImage bids;
+  DepthImage asks;
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+//  20. CALL AUCTION — Equilibrium price search over dense level arrays
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Uncrossing price of a call auction: the tick that executes the most
+/// volume. Works on per-tick quantities gathered from a crossed book, lowest
+/// tick first, over the range [best ask, best bid] (no other tick can trade).
+///
+/// At tick i, demand D(i) = bid qty at ticks >= i (a suffix sum) and supply
+/// S(i) = ask qty at ticks <= i (a prefix sum); i executes min(D, S).
+/// Ties go to the smaller imbalance |D - S|, then to the tick nearest the
+/// reference, then to the lower tick.
+///
+/// Design:
+///   - Curves are doubles: sums of up to PRICE_WINDOW_LEVELS 32-bit level
+///   totals stay below 2^53, so they are exact, and SSE2 (baseline on
+///   x86-64) has packed double add / min / compare, but no 64-bit integer
+///   compare
+///   - Prefix sums are a loop-carried chain. The SIMD kernel works in blocks
+///   of BLOCK ticks: in-block sums are independent, so the chain is one
+///   add per block instead of one per tick
+///   - Three passes: demand suffix sum (in place); supply prefix sum (in
+///   place) with the best volume in four independent maxima; then a scan
+///   that tie-breaks only the ticks executing that volume
+///   - find_equilibrium_scalar() is the same search one tick at a time: the
+///   fallback without SSE2 and the reference the SIMD result must equal
+///
+/// Complexity: O(n), n = ticks between best ask and best bid
+namespace auction {
+
+/// Ticks per SIMD step; callers pad the range to a multiple with zero ticks.
+inline constexpr std::size_t BLOCK = 8;
+
+struct Equilibrium {
+  std::size_t index = 0;  // tick offset into the scanned range
+  uint64_t volume = 0;    // 0 = nothing crosses
+  uint64_t imbalance = 0; // |demand - supply| left over at that tick
+};
+
+/// Tick order: more volume, then less imbalance, then nearer the reference.
+[[nodiscard]] inline bool beats(double volume, double imbalance,
+                                double distance, double best_volume,
+                                double best_imbalance,
+                                double best_distance) noexcept {
+  if (volume != best_volume)
+    return volume > best_volume;
+  if (imbalance != best_imbalance)
+    return imbalance < best_imbalance;
+  return distance < best_distance;
+}
+
+/// Search `n` ticks of bid and ask quantity for the uncrossing tick.
+/// `bids` is overwritten with the demand curve. `ref` is the tick index of
+/// the reference price.
+[[nodiscard]] inline Equilibrium
+find_equilibrium_scalar(double *bids, const double *asks, std::size_t n,
+                        std::size_t ref) noexcept {
+  double demand = 0;
+  for (std::size_t i = n; i-- > 0;)
+    bids[i] = demand += bids[i];
+
+  double supply = 0;
+  double best_volume = -1, best_imbalance = 0, best_distance = 0;
+  std::size_t best = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    supply += asks[i];
+    double volume = std::min(bids[i], supply);
+    double imbalance = std::abs(bids[i] - supply);
+    double distance =
+        std::abs(static_cast<double>(i) - static_cast<double>(ref));
+    if (beats(volume, imbalance, distance, best_volume, best_imbalance,
+              best_distance)) {
+      best_volume = volume;
+      best_imbalance = imbalance;
+      best_distance = distance;
+      best = i;
+    }
+  }
+  if (best_volume <= 0)
+    return {};
+  return {best, static_cast<uint64_t>(best_volume),
+          static_cast<uint64_t>(best_imbalance)};
+}
+
+#if HYPER_CORE_SSE2
+
+/// [x0, x1] -> [x0, x0 + x1]
+[[nodiscard]] inline __m128d pair_prefix(__m128d x) noexcept {
+  return _mm_add_pd(x, _mm_unpacklo_pd(_mm_setzero_pd(), x));
+}
+/// [x0, x1] -> [x0 + x1, x1]
+[[nodiscard]] inline __m128d pair_suffix(__m128d x) noexcept {
+  return _mm_add_pd(x, _mm_unpackhi_pd(x, _mm_setzero_pd()));
+}
+[[nodiscard]] inline __m128d broadcast_lo(__m128d x) noexcept {
+  return _mm_unpacklo_pd(x, x);
+}
+[[nodiscard]] inline __m128d broadcast_hi(__m128d x) noexcept {
+  return _mm_unpackhi_pd(x, x);
+}
+
+/// SSE2 kernel, eight ticks per step. `n` must be a multiple of
+/// BLOCK (pad with zero ticks). `asks` is overwritten with the
+/// supply curve.
+[[nodiscard]] inline Equilibrium find_equilibrium(double *bids, double *asks,
+                                                  std::size_t n,
+                                                  std::size_t ref) noexcept {
+  assert(n % BLOCK == 0);
+
+  // Demand, top block first. Pair sums and the block's running totals do
+  // not depend on the carry, so the loop-carried chain is one add per block
+  __m128d carry = _mm_setzero_pd();
+  for (std::size_t i = n; i > 0;) {
+    i -= BLOCK;
+    __m128d s0 = pair_suffix(_mm_loadu_pd(bids + i));
+    __m128d s1 = pair_suffix(_mm_loadu_pd(bids + i + 2));
+    __m128d s2 = pair_suffix(_mm_loadu_pd(bids + i + 4));
+    __m128d s3 = pair_suffix(_mm_loadu_pd(bids + i + 6));
+    __m128d above2 = broadcast_lo(s3);
+    __m128d above1 = _mm_add_pd(above2, broadcast_lo(s2));
+    __m128d above0 = _mm_add_pd(above1, broadcast_lo(s1));
+    __m128d block = _mm_add_pd(above0, broadcast_lo(s0));
+    _mm_storeu_pd(bids + i + 6, _mm_add_pd(s3, carry));
+    _mm_storeu_pd(bids + i + 4, _mm_add_pd(s2, _mm_add_pd(above2, carry)));
+    _mm_storeu_pd(bids + i + 2, _mm_add_pd(s1, _mm_add_pd(above1, carry)));
+    _mm_storeu_pd(bids + i, _mm_add_pd(s0, _mm_add_pd(above0, carry)));
+    carry = _mm_add_pd(carry, block);
+  }
+
+  // Supply, bottom block first, and the most volume any tick executes
+  // (four independent maxima)
+  carry = _mm_setzero_pd();
+  __m128d most0 = _mm_setzero_pd(), most1 = most0, most2 = most0,
+          most3 = most0;
+  for (std::size_t i = 0; i < n; i += BLOCK) {
+    __m128d p0 = pair_prefix(_mm_loadu_pd(asks + i));
+    __m128d p1 = pair_prefix(_mm_loadu_pd(asks + i + 2));
+    __m128d p2 = pair_prefix(_mm_loadu_pd(asks + i + 4));
+    __m128d p3 = pair_prefix(_mm_loadu_pd(asks + i + 6));
+    __m128d below1 = broadcast_hi(p0);
+    __m128d below2 = _mm_add_pd(below1, broadcast_hi(p1));
+    __m128d below3 = _mm_add_pd(below2, broadcast_hi(p2));
+    __m128d block = _mm_add_pd(below3, broadcast_hi(p3));
+    p0 = _mm_add_pd(p0, carry);
+    p1 = _mm_add_pd(p1, _mm_add_pd(below1, carry));
+    p2 = _mm_add_pd(p2, _mm_add_pd(below2, carry));
+    p3 = _mm_add_pd(p3, _mm_add_pd(below3, carry));
+    carry = _mm_add_pd(carry, block);
+    _mm_storeu_pd(asks + i, p0);
+    _mm_storeu_pd(asks + i + 2, p1);
+    _mm_storeu_pd(asks + i + 4, p2);
+    _mm_storeu_pd(asks + i + 6, p3);
+    most0 = _mm_max_pd(most0, _mm_min_pd(_mm_loadu_pd(bids + i), p0));
+    most1 = _mm_max_pd(most1, _mm_min_pd(_mm_loadu_pd(bids + i + 2), p1));
+    most2 = _mm_max_pd(most2, _mm_min_pd(_mm_loadu_pd(bids + i + 4), p2));
+    most3 = _mm_max_pd(most3, _mm_min_pd(_mm_loadu_pd(bids + i + 6), p3));
+  }
+  __m128d most =
+      _mm_max_pd(_mm_max_pd(most0, most1), _mm_max_pd(most2, most3));
+  most = _mm_max_pd(most, _mm_unpackhi_pd(most, most));
+  double best_volume = _mm_cvtsd_f64(most);
+  if (best_volume <= 0)
+    return {};
+
+  // Only ticks executing that volume compete on imbalance and distance;
+  // a block with none of them costs four compares and one branch
+  most = broadcast_lo(most);
+  double best_imbalance = 0, best_distance = 0;
+  std::size_t best = n;
+  auto hit = [&](std::size_t i) {
+    return _mm_cmpeq_pd(
+        _mm_min_pd(_mm_loadu_pd(bids + i), _mm_loadu_pd(asks + i)), most);
+  };
+  for (std::size_t i = 0; i < n; i += BLOCK) {
+    __m128d h0 = hit(i), h1 = hit(i + 2), h2 = hit(i + 4), h3 = hit(i + 6);
+    if (_mm_movemask_pd(_mm_or_pd(_mm_or_pd(h0, h1), _mm_or_pd(h2, h3))) ==
+        0) [[likely]]
+      continue;
+    unsigned hits = static_cast<unsigned>(
+        _mm_movemask_pd(h0) | _mm_movemask_pd(h1) << 2 |
+        _mm_movemask_pd(h2) << 4 | _mm_movemask_pd(h3) << 6);
+    for (; hits != 0; hits &= hits - 1) {
+      std::size_t tick = i + static_cast<std::size_t>(std::countr_zero(hits));
+      double imbalance = std::abs(bids[tick] - asks[tick]);
+      double distance = std::abs(static_cast<double>(tick) -
+                                 static_cast<double>(ref));
+      if (best == n || beats(best_volume, imbalance, distance, best_volume,
+                             best_imbalance, best_distance)) {
+        best_imbalance = imbalance;
+        best_distance = distance;
+        best = tick;
+      }
+    }
+  }
+  return {best, static_cast<uint64_t>(best_volume),
+          static_cast<uint64_t>(best_imbalance)};
+}
+
+#else
+
+[[nodiscard]] inline Equilibrium find_equilibrium(double *bids, double *asks,
+                                                  std::size_t n,
+                                                  std::size_t ref) noexcept {
+  return find_equilibrium_scalar(bids, asks, n, ref);
+}
+
+#endif
+
+} // namespace auction
+
+/// Indicative or final result of a call auction, in book prices.
+struct AuctionQuote {
+  int64_t price = 0;      // 0 = the book does not cross
+  uint64_t volume = 0;    // quantity that trades at `price`
+  uint64_t imbalance = 0; // unmatched quantity left on the heavier side
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+//  21. MATCHING POLICIES — How a taker's quantity is split over one level
+// ═══════════════════════════════════════════════════════════════════════
+
+/// A matching policy allocates `qty` units (at most the level's displayed
+/// quantity) over the live orders resting at one price, calling
+/// `on_fill(maker, units, requeued)` after each maker is filled, with what
+/// PriceLevel::fill() returned. BasicOrderBook takes one as a template
+/// parameter, so the choice is made per book type at compile time and
+/// inlined into every taker path.
+template <typename P>
+concept MatchingPolicy =
+    requires(PriceLevel &level, uint32_t qty, IntrusiveOrderList *dead,
+             void (*on_fill)(Order &, uint32_t, bool)) {
+      P::allocate(level, qty, dead, on_fill);
+      { P::time_priority } -> std::convertible_to<bool>;
+    };
+
+/// Price-time priority: makers are filled oldest first, each as fully as
+/// the remaining quantity allows. What every book did before policies.
+struct PriceTimePriority {
+  static constexpr bool time_priority = true;
+
+  template <typename OnFill>
+  static void allocate(PriceLevel &level, uint32_t qty,
+                       IntrusiveOrderList *dead, OnFill &&on_fill) noexcept {
+    while (qty > 0) {
+      Order *maker = level.front(dead);
+      uint32_t fill = std::min(maker->remaining_qty, qty);
+      bool requeued = level.fill(maker, fill);
+      qty -= fill;
+      on_fill(*maker, fill, requeued);
+    }
+  }
+};
+
+/// Pro-rata: quantity is shared in proportion to each maker's displayed
+/// size, after a priority fill for the order at the top of the queue.
+///
+/// Allocation of `qty` over a level showing Q units:
+///   1. Top order: the oldest live order takes up to PRO_RATA_TOP_CAP units
+///   2. Pro-rata: every live order then takes floor(open * R / Q') of the
+///   R units left, Q' being what the level shows after step 1. Orders
+///   refilled from iceberg reserve during this step are not revisited
+///   3. Rounding: units left over by the floors go in time priority
+///
+/// Design:
+///   - Step 2 gathers up to CHUNK live orders' open quantity into contiguous
+///   arrays, then computes their shares in one loop (SSE2: four at a time)
+///   with no dependence between orders, then applies the fills
+///   - Below 2^26 units per level the shares are computed in doubles, which
+///   is exact there: open * R < 2^52 needs no rounding, and the quotient
+///   cannot round across an integer. Larger levels use 64-bit integers
+///
+/// Complexity: O(K) for the K orders on the level
+struct ProRata {
+  static constexpr bool time_priority = false;
+  static constexpr std::size_t CHUNK = 64;
+
+  template <typename OnFill>
+  static void allocate(PriceLevel &level, uint32_t qty,
+                       IntrusiveOrderList *dead, OnFill &&on_fill) noexcept {
+    if (qty == 0)
+      return;
+    Order *top = level.front(dead);
+    uint32_t first =
+        std::min({qty, top->remaining_qty, config::PRO_RATA_TOP_CAP});
+    if (first > 0) {
+      bool requeued = level.fill(top, first);
+      qty -= first;
+      on_fill(*top, first, requeued);
+    }
+    if (qty > 0)
+      qty -= share_out(level, qty, on_fill);
+    PriceTimePriority::allocate(level, qty, dead, on_fill);
+  }
+
+  /// floor(open[i] * units / shown) for i < n, into `shares`.
+  static void compute_shares(const uint32_t *open, uint32_t *shares,
+                             std::size_t n, uint32_t units,
+                             uint32_t shown) noexcept {
+    std::size_t i = 0;
+    if (shown < (1u << 26)) {
+#if HYPER_CORE_SSE2
+      const __m128d r = _mm_set1_pd(static_cast<double>(units));
+      const __m128d q = _mm_set1_pd(static_cast<double>(shown));
+      for (; i + 4 <= n; i += 4) {
+        __m128i v =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(open + i));
+        __m128d lo = _mm_cvtepi32_pd(v);
+        __m128d hi = _mm_cvtepi32_pd(_mm_unpackhi_epi64(v, v));
+        lo = _mm_div_pd(_mm_mul_pd(lo, r), q);
+        hi = _mm_div_pd(_mm_mul_pd(hi, r), q);
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(shares + i),
+            _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi)));
+      }
+#endif
+      for (; i < n; ++i) {
+        shares[i] = static_cast<uint32_t>(static_cast<double>(open[i]) *
+                                          units / shown);
+      }
+      return;
+    }
+    for (; i < n; ++i)
+      shares[i] = static_cast<uint32_t>(uint64_t{open[i]} * units / shown);
+  }
+
+private:
+  /// Step 2 over the whole level. Returns the units allocated (<= units).
+  template <typename OnFill>
+  static uint32_t share_out(PriceLevel &level, uint32_t units,
+                            OnFill &on_fill) noexcept {
+    const uint32_t shown = level.total_qty();
+    Order *const last = level.back(); // refilled icebergs land after it
+    Order *node = level.head();
+    std::array<Order *, CHUNK> makers;
+    alignas(16) std::array<uint32_t, CHUNK> open;
+    alignas(16) std::array<uint32_t, CHUNK> shares;
+    uint32_t allocated = 0;
+
+    while (node) {
+      std::size_t n = 0;
+      for (; node && n < CHUNK;
+           node = (node == last) ? nullptr : node->next) {
+        if (node->active && node->remaining_qty > 0) {
+          makers[n] = node;
+          open[n] = node->remaining_qty;
+          ++n;
+        }
+      }
+      compute_shares(open.data(), shares.data(), n, units, shown);
+      for (std::size_t i = 0; i < n; ++i) {
+        if (shares[i] == 0)
+          continue;
+        bool requeued = level.fill(makers[i], shares[i]);
+        allocated += shares[i];
+        on_fill(*makers[i], shares[i], requeued);
+      }
+    }
+    return allocated;
+  }
+};
+
+static_assert(MatchingPolicy<PriceTimePriority>);
+static_assert(MatchingPolicy<ProRata>);
+
+// ═══════════════════════════════════════════════════════════════════════
+//  22. ORDER BOOK — Bid/Ask with Price-Time Matching
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Cache-friendly order book with flat vector price levels.
+///
+/// Design:
+///   - Per-book tick size; prices must be a multiple of it
+///   - Sliding window of PRICE_WINDOW_LEVELS ticks [base_tick_, base_tick_ +
+///   W), initially centered on a reference price. Levels are a ring: tick t
+///   lives in slot t & (W - 1), so moving the window never moves a level
+///   - An order outside the window re-centers it on the order's tick, as long
+///   as every resting level still fits. Only the slots entering the window
+///   are repriced: O(min(shift, W)), bounded by W
+///   - Order ID -> Order* lookup via OrderIdMap, either owned or shared with
+///   the other books of an InstrumentDirectory; cancel unlinks the order from
+///   its level's doubly-linked list in O(1)
+///   - Matching: a taker works through the opposite side one level at a
+///   time; `Policy` (PriceTimePriority or ProRata) splits its quantity over
+///   the makers at each level. Each fill prints at the maker's price and, if
+///   a sink is attached, is published as an ExecutionReport (one clock read
+///   per incoming order)
+///   - Every change to a level's displayed quantity marks the level dirty in
+///   the attached MarketDataSink, if any; the owner flushes one LevelDelta
+///   per dirty level after each message. It also flags the book's
+///   TopOfBookCell, which publish_top() rewrites only if L1 really changed,
+///   and its DepthCacheCell, which publish_depth() rewrites only if one of
+///   the best CONFLATED_DEPTH levels of a side changed
+///   - Every change to a single resting order (rest, in-place amend, cancel,
+///   per-maker fill) is published at once as an OrderEvent, if an
+///   OrderFeedSink is attached
+///   - LIMIT messages enter through submit_limit(): the order crosses the
+///   opposite side before it can rest, so a marketable order never touches
+///   its own side of the book
+///   - Dead orders never stay behind: cancelled ones are unlinked at once,
+///   filled ones are unlinked as matching moves past them, and a drained
+///   level hands its whole list over in O(1). All go to the graveyard, whose
+///   owner returns them to the ObjectPool in bounded batches
+///   - A filled head that no later match walks past is picked up by
+///   compact_step(), a resumable sweep over occupied levels run when idle
+///   - Per-side OccupancyBitmap of levels with live quantity: when the best
+///   level empties, the next one is found in O(1) instead of stepping over
+///   every empty PriceLevel in between
+///   - Icebergs (peak_qty > 0) rest with only peak_qty shown; PriceLevel
+///   refills the slice from hidden_qty in place as it fills. An incoming
+///   iceberg crosses with its full size before the residual is split
+///   - STOP / STOP_LIMIT orders park off-book in a trigger index laid out like
+///   the levels: per side, one FIFO list per window slot plus an
+///   OccupancyBitmap, and the nearest trigger cached like the best prices.
+///   After a trade one comparison per side tells whether any stop fired;
+///   fired stops run as the aggressor right there, in trigger order, and
+///   may set off further stops
+///   - Call auction: between begin_auction() and uncross() nothing trades.
+///   Orders rest even if they cross, and the book may lock or cross. uncross()
+///   finds the single price that executes the most volume with the kernel in
+///   auction::, over the dense level arrays between best ask and best bid,
+///   then pairs FIFO heads at that price until one side runs out. Stops
+///   stay parked through the call and run after it
+///   - snapshot() images the full depth from a per-tick quantity shadow kept
+///   next to the levels (structure of arrays), in bulk copies
+///   - Hot scalars (best indices, map pointer) lead the object; the level
+///   arrays live in separate heap blocks that cold books never touch
+///
+/// Complexity:
+///   add_order: O(1) guaranteed (index + intrusive list push_back, ZERO alloc)
+///              plus O(min(shift, W)) on the rare re-centering
+///   submit_limit: add_order cost plus O(F) for F fills on entry
+///   cancel:    O(1) (lookup + unlink), parked stops included
+///   replace:   O(1) in place or across levels, plus O(F) if it crosses
+///   submit_stop: O(1) to park; each stop runs once, at submit_limit() cost
+///   uncross:   O(n) search over the n crossing ticks, plus O(F) for F fills
+///   snapshot:  O(n) bulk copy over the n ticks between deepest and best
+///   match:     O(L * K) where L = crossing levels, K = orders per level;
+///              independent of the price gap between crossing levels
+template <MatchingPolicy Policy>
+class alignas(config::CACHE_LINE_SIZE) BasicOrderBook {
+  static constexpr std::size_t WINDOW = config::PRICE_WINDOW_LEVELS;
+  static constexpr std::size_t WINDOW_MASK = WINDOW - 1;
+  using LevelBitmap = OccupancyBitmap<WINDOW>;
+
+public:
+  /// Best index of an empty side.
+  static constexpr std::size_t NO_LEVEL = LevelBitmap::NONE;
+
+  /// submit_limit() result for an order the book refused.
+  static constexpr uint64_t REJECTED = ~uint64_t{0};
+
+  /// `shared_ids` == nullptr gives the book its own private ID map.
+  explicit BasicOrderBook(OrderIdMap *shared_ids = nullptr,
+                     int64_t tick_size = config::DEFAULT_TICK_SIZE,
+                     int64_t reference_price = config::MID_PRICE)
+      : ids_(shared_ids), tick_size_(tick_size) {
+    if (!ids_) {
+      owned_ids_ = std::make_unique<OrderIdMap>();
+      ids_ = owned_ids_.get();
+    }
+
+    bid_levels_.resize(WINDOW);
+    ask_levels_.resize(WINDOW);
+    bid_depth_.resize(WINDOW);
+    ask_depth_.resize(WINDOW);
+    buy_stops_.resize(WINDOW);
+    sell_stops_.resize(WINDOW);
+
+    // Center the window on the reference price and price every slot
+    base_tick_ = std::max<int64_t>(
+        reference_price / tick_size_ - static_cast<int64_t>(WINDOW / 2), 0);
+    reprice_ticks(base_tick_, base_tick_ + static_cast<int64_t>(WINDOW));
+  }
+
+  // ─────────── API ───────────
+
+  /// Attach the outbound fill stream (nullptr detaches).
+  void set_execution_sink(ExecutionSink *sink) noexcept { executions_ = sink; }
+
+  /// Attach the L2 level-delta feed, tagging deltas with `instrument_id`
+  /// (nullptr detaches). The owner calls sink->flush() after each message.
+  void set_market_data_sink(MarketDataSink *sink,
+                            uint16_t instrument_id) noexcept {
+    market_data_ = sink;
+    instrument_id_ = instrument_id;
+  }
+
+  /// Attach the L3 order-by-order feed (nullptr detaches).
+  void set_order_feed_sink(OrderFeedSink *sink) noexcept { order_feed_ = sink; }
+
+  /// Attach the L1 cell publish_top() writes to (nullptr detaches). With
+  /// `stale` the book appends itself there the first time its levels change
+  /// after a publish_top(), so the owner publishes only the books a message
+  /// touched.
+  void set_top_of_book(TopOfBookCell *cell,
+                       std::vector<BasicOrderBook *> *stale = nullptr) {
+    top_ = cell;
+    stale_tops_ = stale;
+    top_stale_ = false;
+    published_ = TopOfBook{};
+    publish_top();
+  }
+
+  /// Attach the conflated depth cell publish_depth() writes to (nullptr
+  /// detaches). Like the L1 cell, it is flagged through `stale` given to
+  /// set_top_of_book().
+  void set_depth_cache(DepthCacheCell *cell) noexcept {
+    depth_ = cell;
+    published_depth_ = ConflatedDepth{};
+    publish_depth(0);
+  }
+
+  /// Write the best CONFLATED_DEPTH levels of each side, stamped with the L2
+  /// feed's `feed_sequence`, to the attached cell if any of them changed
+  /// since the last write. Walks the occupancy bitmaps from the best level
+  /// out: O(CONFLATED_DEPTH), independent of the subscribers.
+  void publish_depth(uint64_t feed_sequence) noexcept {
+    if (!depth_)
+      return;
+    ConflatedDepth depth;
+    std::size_t idx = best_bid_idx_;
+    for (std::size_t i = 0; i < config::CONFLATED_DEPTH && idx != NO_LEVEL;
+         ++i, idx = slot_below(bid_occupied_, idx))
+      depth.bids[i] = {bid_levels_[idx].price(), bid_levels_[idx].total_qty()};
+    idx = best_ask_idx_;
+    for (std::size_t i = 0; i < config::CONFLATED_DEPTH && idx != NO_LEVEL;
+         ++i, idx = slot_above(ask_occupied_, idx))
+      depth.asks[i] = {ask_levels_[idx].price(), ask_levels_[idx].total_qty()};
+    if (depth.bids == published_depth_.bids &&
+        depth.asks == published_depth_.asks)
+      return;
+    depth.feed_sequence = feed_sequence;
+    published_depth_ = depth;
+    depth_->publish(depth);
+  }
+
+  /// Write best bid/ask (price and displayed size) and the last trade to
+  /// the attached cell, if any of them changed since the last write. The
+  /// cell's line is left alone otherwise, so readers keep their copy. O(1).
+  void publish_top() noexcept {
+    top_stale_ = false;
+    if (!top_)
+      return;
+    TopOfBook top;
+    if (best_bid_idx_ != NO_LEVEL) {
+      top.bid_price = bid_levels_[best_bid_idx_].price();
+      top.bid_qty = bid_levels_[best_bid_idx_].total_qty();
+    }
+    if (best_ask_idx_ != NO_LEVEL) {
+      top.ask_price = ask_levels_[best_ask_idx_].price();
+      top.ask_qty = ask_levels_[best_ask_idx_].total_qty();
+    }
+    top.last_trade_price = last_trade_price_;
+    if (top == published_)
+      return;
+    published_ = top;
+    top_->publish(top);
+  }
+
+  /// Copy the full depth of both sides into `out` (all but `sequence`).
+  /// Reads only the per-tick quantity shadow, never a PriceLevel, so each
+  /// side is at most two bulk copies. O(occupied tick range), ZERO alloc.
+  void snapshot(BookSnapshot &out) const noexcept {
+    out.tick_size = tick_size_;
+    copy_depth(bid_occupied_, bid_depth_, out.bids);
+    copy_depth(ask_occupied_, ask_depth_, out.asks);
+  }
+
+  /// Collect dead orders into `graveyard` for reclamation. With nullptr they
+  /// are only unlinked (their pool slots are never recycled).
+  void set_graveyard(IntrusiveOrderList *graveyard) noexcept {
+    graveyard_ = graveyard;
+  }
+
+  /// Add a limit order to the book. Returns false (order not added) if the
+  /// price is off-tick, or outside the window and re-centering would push a
+  /// resting level out of it, or if the ID index refuses the order ID.
+  bool add_order(Order *order) {
+    std::size_t level_idx = admit(order);
+    if (level_idx == NO_LEVEL) [[unlikely]]
+      return false;
+    split_display(*order);
+    rest(order, level_idx);
+    return true;
+  }
+
+  /// LIMIT entry (cross-on-entry): trade against the opposite side first,
+  /// each fill at the maker's price, then rest only the residual. Same fills
+  /// as add_order() + match(), without resting a marketable order and then
+  /// rescanning both sides for it. Returns the filled quantity, stops it set
+  /// off included, or REJECTED (nothing traded) where add_order() would
+  /// return false. A fully filled order goes straight to the graveyard.
+  uint64_t submit_limit(Order *order) {
+    std::size_t level_idx = admit(order);
+    if (level_idx == NO_LEVEL) [[unlikely]]
+      return REJECTED;
+
+    order->remaining_qty += std::exchange(order->hidden_qty, 0);
+    uint64_t filled = cross(*order);
+    split_display(*order);
+    settle(order, level_idx);
+    return filled > 0 ? filled + trigger_stops() : 0;
+  }
+
+  /// STOP / STOP_LIMIT entry (by `order->type`): park the order off-book
+  /// until a trade prints at or through `trigger_price` (buy stops: at or
+  /// above it, sell stops: at or below), then run it as a market order (STOP)
+  /// or as a limit order at its own price (STOP_LIMIT) within the trade that
+  /// set it off. A stop the last trade has already reached runs at once, or
+  /// during a call auction stays parked until uncross() sets it off.
+  /// Returns the quantity traded, or REJECTED if the trigger or a STOP_LIMIT
+  /// price is off-tick, the trigger cannot be brought into the window, or the
+  /// ID index refuses the order, or it is an iceberg. A parked stop can be
+  /// cancelled, not amended.
+  uint64_t submit_stop(Order *order, int64_t trigger_price) {
+    if (!is_stop(*order) || order->hidden_qty != 0) [[unlikely]]
+      return REJECTED;
+    if (trigger_price <= 0 || trigger_price % tick_size_ != 0) [[unlikely]]
+      return REJECTED;
+    if (order->type == OrderType::STOP_LIMIT &&
+        (order->price <= 0 || order->price % tick_size_ != 0)) [[unlikely]]
+      return REJECTED;
+    int64_t tick = trigger_price / tick_size_;
+    if (tick > static_cast<int64_t>(UINT32_MAX)) [[unlikely]]
+      return REJECTED;
+    if (!in_window(tick) && !recenter_to_include(tick)) [[unlikely]]
+      return REJECTED;
+    if (!ids_->insert(order)) [[unlikely]]
+      return REJECTED;
+    order->active = 1;
+
+    bool reached = order->side == Side::BID
+                       ? last_trade_price_ >= trigger_price
+                       : last_trade_price_ != 0 &&
+                             last_trade_price_ <= trigger_price;
+    if (!reached || auction_) {
+      park(order, tick);
+      return 0;
+    }
+    uint64_t filled = run_stop(order);
+    return filled > 0 ? filled + trigger_stops() : 0;
+  }
+
+  /// Amend a live order (REPLACE). `new_qty` is its new open quantity,
+  /// reserve included; 0 cancels it. Queue priority follows the usual
+  /// exchange rule:
+  ///   - same price, less qty: updated in place, keeps its place in the queue
+  ///   - same price, more qty: moves to the tail of its level, unless it is
+  ///   an iceberg: the extra goes to the reserve and the queue sees nothing
+  ///   - new price: unlinked and re-entered at the new level with no pool
+  ///   traffic; a price that crosses trades on entry, like submit_limit()
+  /// Returns the quantity filled by the amend, or REJECTED (order unchanged)
+  /// if the order is not live, or the new price is off-tick or cannot be
+  /// brought into the window.
+  uint64_t replace_order(uint64_t order_id, int64_t new_price,
+                         uint32_t new_qty) {
+    Order *order = ids_->find(order_id);
+    if (!order || !order->active || is_stop(*order)) [[unlikely]]
+      return REJECTED;
+    if (new_qty == 0)
+      return cancel_order(order_id) ? 0 : REJECTED;
+
+    uint32_t shown = order->remaining_qty;
+    if (new_price == order->price) {
+      PriceLevel &level = level_of(*order);
+      if (new_qty <= shown || order->peak_qty != 0) {
+        // The displayed size does not grow: same place in the queue
+        uint32_t keep = std::min(shown, new_qty);
+        level.reduce_qty(shown - keep);
+        resize(*order, keep, new_qty - keep);
+        if (keep != shown)
+          feed(OrderEventType::MODIFY, *order, keep);
+      } else {
+        level.remove(order, shown);
+        feed(OrderEventType::CANCEL, *order, shown);
+        resize(*order, new_qty, 0);
+        level.add_order(order); // more size goes to the back of the queue
+        feed(OrderEventType::ADD, *order, new_qty);
+      }
+      touch(order->side, level);
+      ++replace_count_;
+      return 0;
+    }
+
+    if (new_price <= 0 || new_price % tick_size_ != 0) [[unlikely]]
+      return REJECTED;
+    int64_t tick = new_price / tick_size_;
+    if (!in_window(tick) && !recenter_to_include(tick)) [[unlikely]]
+      return REJECTED;
+
+    leave_level(order, shown);
+    order->price = new_price;
+    resize(*order, new_qty, 0);
+    aggressor_side_ = order->side;
+
+    uint64_t filled = cross(*order);
+    split_display(*order);
+    settle(order, slot_of_tick(tick));
+    ++replace_count_;
+    return filled > 0 ? filled + trigger_stops() : 0;
+  }
+
+  /// Cancel an order by ID. O(1).
+  /// Updates PriceLevel cached_qty_ to prevent stale-quantity infinite loops.
+  bool cancel_order(uint64_t order_id) { return cancel(ids_->find(order_id)); }
+
+  /// Cancel an order already in hand. O(1).
+  /// Returns false if it is null or no longer live.
+  bool cancel(Order *order) noexcept {
+    if (!order || !order->active) {
+      return false;
+    }
+    withdraw(order);
+    refresh_best();
+    return true;
+  }
+
+  /// Cancel a live order of this book without re-deriving the best prices,
+  /// for batches (mass cancel): a level it empties is unmarked, but best
+  /// bid/ask may point at an empty level until refresh_best() is called.
+  /// Nothing may match or rest on the book in between. O(1).
+  void withdraw(Order *order) noexcept {
+    uint32_t cancelled_qty = std::exchange(order->remaining_qty, 0);
+    order->hidden_qty = 0;
+    order->active = 0;
+    ids_->erase(order->id);
+
+    if (is_stop(*order)) [[unlikely]] {
+      unpark(order); // never reached the book
+    } else if (std::size_t idx = slot_of_price(order->price);
+               order->side == Side::BID) {
+      feed(OrderEventType::CANCEL, *order, cancelled_qty);
+      bid_levels_[idx].remove(order, cancelled_qty);
+      touch(Side::BID, bid_levels_[idx]);
+      if (bid_levels_[idx].total_qty() == 0)
+        clear_bid(idx);
+    } else {
+      feed(OrderEventType::CANCEL, *order, cancelled_qty);
+      ask_levels_[idx].remove(order, cancelled_qty);
+      touch(Side::ASK, ask_levels_[idx]);
+      if (ask_levels_[idx].total_qty() == 0)
+        clear_ask(idx);
+    }
+    if (graveyard_)
+      graveyard_->push_back(order);
+
+    ++cancel_count_;
+  }
+
+  /// Re-derive best bid/ask after a batch of withdraw() calls: one bitmap
+  /// search per side, and only if its best level was emptied.
+  void refresh_best() noexcept {
+    if (best_bid_idx_ != NO_LEVEL && !bid_occupied_.test(best_bid_idx_))
+      best_bid_idx_ = highest_slot(bid_occupied_);
+    if (best_ask_idx_ != NO_LEVEL && !ask_occupied_.test(best_ask_idx_))
+      best_ask_idx_ = lowest_slot(ask_occupied_);
+  }
+
+  /// Match crossing orders (bid >= ask), one maker/taker pair per fill.
+  /// Returns total filled quantity, stops set off included. A no-op during
+  /// a call auction. Pairs queue heads, so only for time-priority books.
+  uint64_t match()
+    requires(Policy::time_priority)
+  {
+    if (auction_) [[unlikely]]
+      return 0;
+    uint64_t total_filled = 0;
+    uint64_t now = 0; // Matcher clock, read on the first fill only
+
+    while (best_bid_idx_ != NO_LEVEL && best_ask_idx_ != NO_LEVEL) {
+      auto &bid_level = bid_levels_[best_bid_idx_];
+      auto &ask_level = ask_levels_[best_ask_idx_];
+
+      // Crossing condition: best bid price >= best ask price
+      if (bid_level.price() < ask_level.price())
+        break;
+
+      // Both heads are live by the bitmap invariant (level qty > 0)
+      Order *bid = bid_level.front(graveyard_);
+      Order *ask = ask_level.front(graveyard_);
+      uint32_t match_qty = std::min(bid->remaining_qty, ask->remaining_qty);
+      execute(bid_level, bid, match_qty);
+      execute(ask_level, ask, match_qty);
+      touch(Side::BID, bid_level);
+      touch(Side::ASK, ask_level);
+
+      total_filled += match_qty;
+      ++match_count_;
+      last_trade_price_ = aggressor_side_ == Side::BID ? ask_level.price()
+                                                       : bid_level.price();
+
+      // The book is uncrossed between adds, so only the side of the last add
+      // can be crossing: it is the taker and trades at the maker's price
+      if (executions_) {
+        if (aggressor_side_ == Side::BID)
+          publish(*ask, *bid, ask_level.price(), match_qty, now);
+        else
+          publish(*bid, *ask, bid_level.price(), match_qty, now);
+      }
+
+      // Advance best levels if exhausted: O(1) via the occupancy bitmaps
+      if (bid_level.total_qty() == 0)
+        unmark_bid(best_bid_idx_);
+      if (ask_level.total_qty() == 0)
+        unmark_ask(best_ask_idx_);
+    }
+
+    return total_filled > 0 ? total_filled + trigger_stops() : 0;
+  }
+
+  /// Match a market order immediately against the book, one resting maker
+  /// per fill. Returns the filled quantity, stops set off included. During a
+  /// call auction nothing trades and 0 is returned.
+  uint64_t match_market(Order *order) {
+    uint64_t filled = sweep_side(*order);
+    return filled > 0 ? filled + trigger_stops() : 0;
+  }
+
+  /// Resume the idle sweep: visit occupied levels (bids, then asks) from
+  /// where the last call stopped and move their dead heads to the graveyard.
+  /// Spends at most `budget` units, one per order moved or one for a level
+  /// with nothing to move, and deducts them. Returns true once the sweep has
+  /// passed the last ask level; the next call starts over at the lowest bid.
+  bool compact_step(std::size_t &budget) noexcept {
+    while (budget > 0) {
+      const LevelBitmap &occupied = sweep_asks_ ? ask_occupied_ : bid_occupied_;
+      std::size_t idx = occupied.find_next(sweep_slot_);
+      if (idx == NO_LEVEL) {
+        sweep_slot_ = 0;
+        if (std::exchange(sweep_asks_, !sweep_asks_))
+          return true;
+        continue;
+      }
+
+      // Live qty > 0 on an occupied level, so pruning never empties it
+      auto &level = sweep_asks_ ? ask_levels_[idx] : bid_levels_[idx];
+      std::size_t moved = level.prune(graveyard_, budget);
+      sweep_slot_ = (moved == budget) ? idx : idx + 1; // cut short: revisit
+      budget -= std::max<std::size_t>(moved, 1);
+    }
+    return false;
+  }
+
+  // ─────────── Call auction ───────────
+
+  /// Enter the call phase: orders keep arriving, cancelling and amending,
+  /// but nothing trades until uncross(). Limit orders rest where they are
+  /// priced even if they cross; market orders find nothing to trade
+  /// against. Stops park, even those the last trade has already reached, and
+  /// run once uncross() is done. The first call allocates the search scratch
+  /// (NOT on the hot path).
+  void begin_auction() {
+    if (!auction_scratch_)
+      auction_scratch_ = std::make_unique<AuctionScratch>();
+    auction_ = true;
+  }
+
+  [[nodiscard]] bool in_auction() const noexcept { return auction_; }
+
+  /// What uncross() would do now: price, volume and leftover imbalance.
+  /// Ties go to the smaller imbalance, then to the price nearest the last
+  /// trade (or the middle of the crossing range before the first trade).
+  /// Empty outside a call auction or when the book does not cross.
+  [[nodiscard]] AuctionQuote auction_quote() noexcept {
+    if (!auction_ || best_bid_idx_ == NO_LEVEL || best_ask_idx_ == NO_LEVEL)
+      return {};
+    std::size_t lo = offset_of(best_ask_idx_);
+    std::size_t hi = offset_of(best_bid_idx_);
+    if (hi < lo)
+      return {};
+
+    // Gather level totals, lowest tick first, padded to a whole block
+    std::size_t n = hi - lo + 1;
+    std::size_t first = slot_of_tick(base_tick_ + static_cast<int64_t>(lo));
+    AuctionScratch &scratch = *auction_scratch_;
+    for (std::size_t i = 0; i < n; ++i) {
+      std::size_t slot = (first + i) & WINDOW_MASK;
+      scratch.bids[i] = bid_levels_[slot].total_qty();
+      scratch.asks[i] = ask_levels_[slot].total_qty();
+    }
+    std::size_t padded = (n + auction::BLOCK - 1) / auction::BLOCK *
+                         auction::BLOCK;
+    std::fill(scratch.bids.begin() + n, scratch.bids.begin() + padded, 0.0);
+    std::fill(scratch.asks.begin() + n, scratch.asks.begin() + padded, 0.0);
+
+    int64_t first_tick = base_tick_ + static_cast<int64_t>(lo);
+    std::size_t ref = (n - 1) / 2;
+    if (last_trade_price_ != 0) {
+      ref = static_cast<std::size_t>(
+          std::clamp<int64_t>(last_trade_price_ / tick_size_ - first_tick, 0,
+                              static_cast<int64_t>(n - 1)));
+    }
+    auction::Equilibrium eq = auction::find_equilibrium(
+        scratch.bids.data(), scratch.asks.data(), padded, ref);
+    if (eq.volume == 0)
+      return {};
+    return {(first_tick + static_cast<int64_t>(eq.index)) * tick_size_,
+            eq.volume, eq.imbalance};
+  }
+
+  /// End the call phase: trade every bid at or above the auction price
+  /// against every ask at or below it, all at that price, in price-time
+  /// order on each side (whatever the policy), then resume continuous
+  /// trading. Iceberg reserve refilled along the way trades at the same
+  /// price. The residual book is uncrossed. Returns the filled quantity,
+  /// stops set off included.
+  uint64_t uncross() {
+    AuctionQuote quote = auction_quote();
+    auction_ = false;
+    if (quote.volume == 0)
+      return trigger_stops(); // those reached before or during the call
+
+    uint64_t filled = 0;
+    uint64_t now = 0;
+    while (best_bid_idx_ != NO_LEVEL && best_ask_idx_ != NO_LEVEL) {
+      auto &bid_level = bid_levels_[best_bid_idx_];
+      auto &ask_level = ask_levels_[best_ask_idx_];
+      if (bid_level.price() < quote.price || ask_level.price() > quote.price)
+        break;
+
+      Order *bid = bid_level.front(graveyard_);
+      Order *ask = ask_level.front(graveyard_);
+      uint32_t qty = std::min(bid->remaining_qty, ask->remaining_qty);
+      execute(bid_level, bid, qty);
+      execute(ask_level, ask, qty);
+      touch(Side::BID, bid_level);
+      touch(Side::ASK, ask_level);
+      filled += qty;
+      ++match_count_;
+
+      // No aggressor in an auction: reported with the ask as maker
+      if (executions_)
+        publish(*ask, *bid, quote.price, qty, now);
+
+      if (bid_level.total_qty() == 0)
+        unmark_bid(best_bid_idx_);
+      if (ask_level.total_qty() == 0)
+        unmark_ask(best_ask_idx_);
+    }
+
+    last_trade_price_ = quote.price;
+    ++auctions_uncrossed_;
+    return filled + trigger_stops();
+  }
+
+  // ─────────── Stats ───────────
+
+  [[nodiscard]] uint64_t match_count() const noexcept { return match_count_; }
+  [[nodiscard]] uint64_t cancel_count() const noexcept { return cancel_count_; }
+  [[nodiscard]] uint64_t replace_count() const noexcept {
+    return replace_count_;
+  }
+
+  [[nodiscard]] uint64_t recenter_count() const noexcept {
+    return recenter_count_;
+  }
+
+  [[nodiscard]] int64_t best_bid_price() const noexcept {
+    if (best_bid_idx_ != NO_LEVEL) {
+      return bid_levels_[best_bid_idx_].price();
+    }
+    return 0;
+  }
+
+  [[nodiscard]] int64_t best_ask_price() const noexcept {
+    if (best_ask_idx_ != NO_LEVEL) {
+      return ask_levels_[best_ask_idx_].price();
+    }
+    return 0;
+  }
+
+  /// Price of the most recent fill in this book, 0 before the first.
+  [[nodiscard]] int64_t last_trade_price() const noexcept {
+    return last_trade_price_;
+  }
+  [[nodiscard]] uint64_t stops_triggered() const noexcept {
+    return stops_triggered_;
+  }
+  [[nodiscard]] uint64_t auctions_uncrossed() const noexcept {
+    return auctions_uncrossed_;
+  }
+
+  [[nodiscard]] int64_t tick_size() const noexcept { return tick_size_; }
+
+  /// Lowest and highest price currently addressable without re-centering.
+  [[nodiscard]] int64_t window_low_price() const noexcept {
+    return base_tick_ * tick_size_;
+  }
+  [[nodiscard]] int64_t window_high_price() const noexcept {
+    return (base_tick_ + static_cast<int64_t>(WINDOW) - 1) * tick_size_;
+  }
+
+private:
+  // ── Fills ──
+
+  /// Validate a limit order and map its ID. Returns its level slot, or
+  /// NO_LEVEL if the price is off-tick or cannot be brought into the window,
+  /// or the ID index refuses it.
+  std::size_t admit(Order *order) noexcept {
+    std::size_t level_idx = place(order->price);
+    if (level_idx == NO_LEVEL) [[unlikely]]
+      return NO_LEVEL;
+
+    // Register in ID map for O(1) cancel
+    if (!ids_->insert(order)) [[unlikely]]
+      return NO_LEVEL;
+
+    order->active = 1;
+    aggressor_side_ = order->side;
+    return level_idx;
+  }
+
+  /// Level slot for a limit price, re-centering the window if needed, or
+  /// NO_LEVEL if the price is off-tick or cannot be brought into the window.
+  std::size_t place(int64_t price) noexcept {
+    if (price <= 0 || price % tick_size_ != 0) [[unlikely]]
+      return NO_LEVEL;
+    int64_t tick = price / tick_size_;
+    if (!in_window(tick) && !recenter_to_include(tick)) [[unlikely]]
+      return NO_LEVEL;
+    return slot_of_tick(tick);
+  }
+
+  /// Trade `taker` against the opposite side for as long as it crosses,
+  /// each fill at the maker's price. Returns the filled quantity; nothing
+  /// trades during a call auction.
+  uint64_t cross(Order &taker) noexcept {
+    if (auction_) [[unlikely]]
+      return 0;
+    uint64_t filled = 0;
+    uint64_t now = 0;
+
+    if (taker.side == Side::BID) {
+      while (taker.remaining_qty > 0 && best_ask_idx_ != NO_LEVEL) {
+        auto &level = ask_levels_[best_ask_idx_];
+        if (level.price() > taker.price)
+          break;
+        filled += take(level, taker, now);
+        if (level.total_qty() == 0)
+          unmark_ask(best_ask_idx_);
+      }
+    } else {
+      while (taker.remaining_qty > 0 && best_bid_idx_ != NO_LEVEL) {
+        auto &level = bid_levels_[best_bid_idx_];
+        if (level.price() < taker.price)
+          break;
+        filled += take(level, taker, now);
+        if (level.total_qty() == 0)
+          unmark_bid(best_bid_idx_);
+      }
+    }
+    return filled;
+  }
+
+  /// Trade `taker` against the opposite side at any price, until it is
+  /// filled or that side is empty. Returns the filled quantity; nothing
+  /// trades during a call auction.
+  uint64_t sweep_side(Order &taker) noexcept {
+    if (auction_) [[unlikely]]
+      return 0;
+    uint64_t filled = 0;
+    uint64_t now = 0;
+
+    if (taker.side == Side::BID) {
+      // Buy: match against asks (ascending)
+      while (taker.remaining_qty > 0 && best_ask_idx_ != NO_LEVEL) {
+        auto &level = ask_levels_[best_ask_idx_];
+        filled += take(level, taker, now);
+        if (level.total_qty() == 0)
+          unmark_ask(best_ask_idx_);
+      }
+    } else {
+      // Sell: match against bids (descending)
+      while (taker.remaining_qty > 0 && best_bid_idx_ != NO_LEVEL) {
+        auto &level = bid_levels_[best_bid_idx_];
+        filled += take(level, taker, now);
+        if (level.total_qty() == 0)
+          unmark_bid(best_bid_idx_);
+      }
+    }
+    return filled;
+  }
+
+  /// After cross(): rest the residual at `level_idx`, or retire a fully
+  /// filled order to the graveyard.
+  void settle(Order *order, std::size_t level_idx) noexcept {
+    if (order->remaining_qty == 0) {
+      retire(order);
+      return;
+    }
+    rest(order, level_idx);
+  }
+
+  /// Take a finished order out of play. It stays mapped, like a filled
+  /// maker, until reclaim() unmaps it.
+  void retire(Order *order) noexcept {
+    order->active = 0;
+    if (graveyard_)
+      graveyard_->push_back(order);
+  }
+
+  // ── Stops ──
+
+  /// Queue a stop at the tail of its trigger tick's list.
+  void park(Order *order, int64_t tick) noexcept {
+    order->stop_tick = static_cast<uint32_t>(tick);
+    std::size_t idx = slot_of_tick(tick);
+    if (order->side == Side::BID) {
+      buy_stops_[idx].push_back(order);
+      buy_stop_occupied_.set(idx);
+      if (next_buy_stop_idx_ == NO_LEVEL ||
+          offset_of(idx) < offset_of(next_buy_stop_idx_))
+        next_buy_stop_idx_ = idx;
+    } else {
+      sell_stops_[idx].push_back(order);
+      sell_stop_occupied_.set(idx);
+      if (next_sell_stop_idx_ == NO_LEVEL ||
+          offset_of(idx) > offset_of(next_sell_stop_idx_))
+        next_sell_stop_idx_ = idx;
+    }
+  }
+
+  /// Unlink a parked stop in O(1). Buy stops fire lowest trigger first,
+  /// sell stops highest first.
+  void unpark(Order *order) noexcept {
+    std::size_t idx = slot_of_tick(std::exchange(order->stop_tick, 0));
+    if (order->side == Side::BID) {
+      buy_stops_[idx].unlink(order);
+      if (buy_stops_[idx].empty()) {
+        buy_stop_occupied_.clear(idx);
+        if (idx == next_buy_stop_idx_)
+          next_buy_stop_idx_ = lowest_slot(buy_stop_occupied_);
+      }
+    } else {
+      sell_stops_[idx].unlink(order);
+      if (sell_stops_[idx].empty()) {
+        sell_stop_occupied_.clear(idx);
+        if (idx == next_sell_stop_idx_)
+          next_sell_stop_idx_ = highest_slot(sell_stop_occupied_);
+      }
+    }
+  }
+
+  /// Run every stop the last trade has reached, oldest first at each
+  /// trigger, including those set off by the fills of earlier ones. With no
+  /// stop in reach this is one comparison per side. Returns the quantity
+  /// they traded.
+  uint64_t trigger_stops() {
+    uint64_t filled = 0;
+    for (;;) {
+      Order *stop;
+      if (next_buy_stop_idx_ != NO_LEVEL &&
+          last_trade_price_ >= price_of_slot(next_buy_stop_idx_)) {
+        stop = buy_stops_[next_buy_stop_idx_].head();
+      } else if (next_sell_stop_idx_ != NO_LEVEL && last_trade_price_ != 0 &&
+                 last_trade_price_ <= price_of_slot(next_sell_stop_idx_)) {
+        stop = sell_stops_[next_sell_stop_idx_].head();
+      } else {
+        return filled;
+      }
+      unpark(stop);
+      filled += run_stop(stop);
+    }
+  }
+
+  /// Execute a triggered stop as the aggressor. A STOP takes liquidity like
+  /// a market order and drops what it cannot fill; a STOP_LIMIT becomes a
+  /// limit order and crosses and rests like submit_limit(), or is dropped if
+  /// its price cannot be brought into the window.
+  uint64_t run_stop(Order *stop) noexcept {
+    ++stops_triggered_;
+    aggressor_side_ = stop->side;
+    if (stop->type == OrderType::STOP_LIMIT) {
+      stop->type = OrderType::LIMIT;
+      std::size_t level_idx = place(stop->price);
+      if (level_idx != NO_LEVEL) [[likely]] {
+        uint64_t filled = cross(*stop);
+        settle(stop, level_idx);
+        return filled;
+      }
+    } else {
+      stop->type = OrderType::MARKET;
+      uint64_t filled = sweep_side(*stop);
+      retire(stop);
+      return filled;
+    }
+    retire(stop);
+    return 0;
+  }
+
+  /// Level a live order rests on. A live order is always in the window.
+  [[nodiscard]] PriceLevel &level_of(const Order &order) noexcept {
+    std::size_t idx = slot_of_price(order.price);
+    return order.side == Side::BID ? bid_levels_[idx] : ask_levels_[idx];
+  }
+
+  /// Unlink a live order carrying `qty` units from its level in O(1). A level
+  /// left without live quantity is unmarked.
+  void leave_level(Order *order, uint32_t qty) noexcept {
+    feed(OrderEventType::CANCEL, *order, qty);
+    std::size_t idx = slot_of_price(order->price);
+    if (order->side == Side::BID) {
+      bid_levels_[idx].remove(order, qty);
+      touch(Side::BID, bid_levels_[idx]);
+      if (bid_levels_[idx].total_qty() == 0)
+        unmark_bid(idx);
+    } else {
+      ask_levels_[idx].remove(order, qty);
+      touch(Side::ASK, ask_levels_[idx]);
+      if (ask_levels_[idx].total_qty() == 0)
+        unmark_ask(idx);
+    }
+  }
+
+  /// Set the shown and hidden open quantity, keeping quantity - open =
+  /// filled so far.
+  static void resize(Order &order, uint32_t shown, uint32_t hidden) noexcept {
+    order.quantity = order.quantity - order.remaining_qty - order.hidden_qty +
+                     shown + hidden;
+    order.remaining_qty = shown;
+    order.hidden_qty = hidden;
+  }
+
+  /// Split the open quantity into the displayed slice (at most peak_qty) and
+  /// the reserve. Leaves a fully shown order (peak_qty == 0) as it is.
+  static void split_display(Order &order) noexcept {
+    uint32_t open = order.remaining_qty + order.hidden_qty;
+    order.remaining_qty =
+        order.peak_qty != 0 ? std::min(open, order.peak_qty) : open;
+    order.hidden_qty = open - order.remaining_qty;
+  }
+
+  /// Still a stop: parked, or about to be. run_stop() retypes it.
+  [[nodiscard]] static bool is_stop(const Order &order) noexcept {
+    return order.type == OrderType::STOP ||
+           order.type == OrderType::STOP_LIMIT;
+  }
+
+  /// Queue an admitted order at the tail of its level.
+  void rest(Order *order, std::size_t level_idx) noexcept {
+    feed(OrderEventType::ADD, *order, order->remaining_qty);
+    if (order->side == Side::BID) {
+      bid_levels_[level_idx].add_order(order);
+      touch(Side::BID, bid_levels_[level_idx]);
+      if (bid_levels_[level_idx].total_qty() > 0)
+        mark_bid(level_idx);
+    } else {
+      ask_levels_[level_idx].add_order(order);
+      touch(Side::ASK, ask_levels_[level_idx]);
+      if (ask_levels_[level_idx].total_qty() > 0)
+        mark_ask(level_idx);
+    }
+  }
+
+  /// Fill `taker` against `level` as far as the level's displayed quantity
+  /// goes, split over its makers by `Policy`. Returns the filled quantity.
+  uint32_t take(PriceLevel &level, Order &taker, uint64_t &now) noexcept {
+    uint32_t qty = std::min(level.total_qty(), taker.remaining_qty);
+    Policy::allocate(level, qty, graveyard_,
+                     [&](Order &maker, uint32_t fill, bool requeued) {
+                       taker.remaining_qty -= fill;
+                       ++match_count_;
+                       if (order_feed_)
+                         feed_fill(maker, fill, requeued);
+                       if (executions_)
+                         publish(maker, taker, level.price(), fill, now);
+                     });
+    touch(taker.side == Side::BID ? Side::ASK : Side::BID, level);
+    last_trade_price_ = level.price();
+    return qty;
+  }
+
+  /// Fill a resting order and report it on the L3 feed.
+  void execute(PriceLevel &level, Order *order, uint32_t qty) noexcept {
+    bool requeued = level.fill(order, qty);
+    if (order_feed_)
+      feed_fill(*order, qty, requeued);
+  }
+
+  /// EXECUTE for a maker fill, then ADD of the next slice if an iceberg went
+  /// back to the tail (the executed slice is gone from the queue).
+  void feed_fill(const Order &maker, uint32_t qty, bool requeued) noexcept {
+    order_feed_->publish(OrderEventType::EXECUTE, maker, qty);
+    if (requeued)
+      order_feed_->publish(OrderEventType::ADD, maker, maker.remaining_qty);
+  }
+
+  void feed(OrderEventType type, const Order &order, uint32_t qty) noexcept {
+    if (order_feed_)
+      order_feed_->publish(type, order, qty);
+  }
+
+  /// A level's displayed quantity changed: mirror it into the depth shadow,
+  /// queue an L2 delta if a feed is attached, and flag the L1 and depth
+  /// cells for the next publish_top() / publish_depth().
+  void touch(Side side, PriceLevel &level) noexcept {
+    if (side == Side::BID)
+      bid_depth_[static_cast<std::size_t>(&level - bid_levels_.data())] =
+          level.total_qty();
+    else
+      ask_depth_[static_cast<std::size_t>(&level - ask_levels_.data())] =
+          level.total_qty();
+    if (market_data_)
+      market_data_->touch(level, instrument_id_, side);
+    if ((top_ || depth_) && !top_stale_) {
+      top_stale_ = true;
+      if (stale_tops_)
+        stale_tops_->push_back(this);
+    }
+  }
+
+  void publish(const Order &maker, const Order &taker, int64_t price,
+               uint32_t qty, uint64_t &now) noexcept {
+    if (now == 0)
+      now = platform::timestamp_ns();
+
+    ExecutionReport report;
+    report.maker_order_id = maker.id;
+    report.taker_order_id = taker.id;
+    report.instrument_id = maker.instrument_id;
+    report.price = price;
+    report.quantity = qty;
+    report.maker_leaves = maker.remaining_qty + maker.hidden_qty;
+    report.taker_leaves = taker.remaining_qty + taker.hidden_qty;
+    report.taker_side = taker.side;
+    report.taker_timestamp = taker.timestamp;
+    report.match_timestamp = now;
+    executions_->publish(report);
+  }
+
+  // ── Occupancy maintenance: a bit is set while the level has live qty ──
+
+  // Slots compare by their offset from the window base, not by slot index
+
+  void mark_bid(std::size_t idx) noexcept {
+    bid_occupied_.set(idx);
+    if (best_bid_idx_ == NO_LEVEL || offset_of(idx) > offset_of(best_bid_idx_))
+      best_bid_idx_ = idx;
+  }
+
+  void mark_ask(std::size_t idx) noexcept {
+    ask_occupied_.set(idx);
+    if (best_ask_idx_ == NO_LEVEL || offset_of(idx) < offset_of(best_ask_idx_))
+      best_ask_idx_ = idx;
+  }
+
+  // A level is unmarked exactly when its qty hits zero: every node on it is
+  // dead, so the whole list goes to the graveyard at once
+
+  void unmark_bid(std::size_t idx) noexcept {
+    clear_bid(idx);
+    if (idx == best_bid_idx_)
+      best_bid_idx_ = highest_slot(bid_occupied_);
+  }
+
+  void unmark_ask(std::size_t idx) noexcept {
+    clear_ask(idx);
+    if (idx == best_ask_idx_)
+      best_ask_idx_ = lowest_slot(ask_occupied_);
+  }
+
+  // As above, leaving best_*_idx_ to refresh_best()
+
+  void clear_bid(std::size_t idx) noexcept {
+    bid_levels_[idx].drain_into(graveyard_);
+    bid_occupied_.clear(idx);
+  }
+
+  void clear_ask(std::size_t idx) noexcept {
+    ask_levels_[idx].drain_into(graveyard_);
+    ask_occupied_.clear(idx);
+  }
+
+  /// Copy one side's occupied tick range out of its depth shadow. The
+  /// range is contiguous in ticks, so in the ring it is one run of slots, or
+  /// two when it wraps past slot WINDOW - 1.
+  void copy_depth(const LevelBitmap &occupied,
+                  const std::vector<uint32_t> &depth,
+                  DepthImage &out) const noexcept {
+    if (!occupied.any()) {
+      out.first_price = 0;
+      out.levels = 0;
+      return;
+    }
+    std::size_t lo = lowest_slot(occupied);
+    std::size_t n = offset_of(highest_slot(occupied)) - offset_of(lo) + 1;
+    std::size_t run = std::min(n, WINDOW - lo);
+    std::memcpy(out.qty.data(), depth.data() + lo, run * sizeof(uint32_t));
+    std::memcpy(out.qty.data() + run, depth.data(),
+                (n - run) * sizeof(uint32_t));
+    out.first_price = price_of_slot(lo);
+    out.levels = n;
+  }
+
+  // ── Ring window: tick t <-> slot t & WINDOW_MASK ──
+
+  [[nodiscard]] static std::size_t slot_of_tick(int64_t tick) noexcept {
+    return static_cast<std::size_t>(tick) & WINDOW_MASK;
+  }
+
+  [[nodiscard]] bool in_window(int64_t tick) const noexcept {
+    return tick >= base_tick_ &&
+           tick < base_tick_ + static_cast<int64_t>(WINDOW);
+  }
+
+  /// Distance of a slot from the window base, in ticks: [0, WINDOW).
+  [[nodiscard]] std::size_t offset_of(std::size_t slot) const noexcept {
+    return (slot - slot_of_tick(base_tick_)) & WINDOW_MASK;
+  }
+
+  [[nodiscard]] int64_t tick_of_slot(std::size_t slot) const noexcept {
+    return base_tick_ + static_cast<int64_t>(offset_of(slot));
+  }
+
+  [[nodiscard]] int64_t price_of_slot(std::size_t slot) const noexcept {
+    return tick_of_slot(slot) * tick_size_;
+  }
+
+  /// Level slot of a price inside the window, or NO_LEVEL. Never re-centers.
+  [[nodiscard]] std::size_t slot_of_price(int64_t price) const noexcept {
+    if (price <= 0 || price % tick_size_ != 0)
+      return NO_LEVEL;
+    int64_t tick = price / tick_size_;
+    return in_window(tick) ? slot_of_tick(tick) : NO_LEVEL;
+  }
+
+  /// Set slot nearest the window base: [base, W) first, then the wrap.
+  [[nodiscard]] std::size_t lowest_slot(const LevelBitmap &bm) const noexcept {
+    std::size_t slot = bm.find_next(slot_of_tick(base_tick_));
+    return (slot != NO_LEVEL) ? slot : bm.find_next(0);
+  }
+
+  /// Set slot farthest from the window base: the wrap [0, base) first.
+  [[nodiscard]] std::size_t highest_slot(const LevelBitmap &bm) const noexcept {
+    std::size_t base = slot_of_tick(base_tick_);
+    if (base > 0) {
+      std::size_t slot = bm.find_prev(base - 1);
+      if (slot != NO_LEVEL)
+        return slot;
+    }
+    return bm.find_prev(WINDOW - 1);
+  }
+
+  /// Next set slot above `slot` in price order (through the wrap), or
+  /// NO_LEVEL.
+  [[nodiscard]] std::size_t slot_above(const LevelBitmap &bm,
+                                       std::size_t slot) const noexcept {
+    std::size_t base = slot_of_tick(base_tick_);
+    if (slot >= base) {
+      std::size_t next = slot + 1 < WINDOW ? bm.find_next(slot + 1) : NO_LEVEL;
+      if (next != NO_LEVEL)
+        return next;
+      slot = WINDOW - 1; // continue in the wrap [0, base)
+    }
+    std::size_t next = bm.find_next((slot + 1) & WINDOW_MASK);
+    return next < base ? next : NO_LEVEL;
+  }
+
+  /// Next set slot below `slot` in price order (through the wrap), or
+  /// NO_LEVEL.
+  [[nodiscard]] std::size_t slot_below(const LevelBitmap &bm,
+                                       std::size_t slot) const noexcept {
+    std::size_t base = slot_of_tick(base_tick_);
+    if (slot < base) {
+      std::size_t prev = slot > 0 ? bm.find_prev(slot - 1) : NO_LEVEL;
+      if (prev != NO_LEVEL)
+        return prev;
+      slot = WINDOW; // continue from the top of [base, W)
+    }
+    if (slot == 0)
+      return NO_LEVEL;
+    std::size_t prev = bm.find_prev(slot - 1);
+    return (prev != NO_LEVEL && prev >= base) ? prev : NO_LEVEL;
+  }
+
+  /// Move the window so it contains `tick`, centered on it where possible.
+  /// Fails if the resting levels and parked stops plus `tick` span more than
+  /// the window.
+  bool recenter_to_include(int64_t tick) {
+    int64_t lo = tick;
+    int64_t hi = tick;
+    for (const LevelBitmap *bm : {&bid_occupied_, &ask_occupied_,
+                                  &buy_stop_occupied_, &sell_stop_occupied_}) {
+      if (!bm->any())
+        continue;
+      lo = std::min(lo, tick_of_slot(lowest_slot(*bm)));
+      hi = std::max(hi, tick_of_slot(highest_slot(*bm)));
+    }
+    const auto window = static_cast<int64_t>(WINDOW);
+    if (hi - lo >= window)
+      return false;
+
+    int64_t old_base = base_tick_;
+    base_tick_ = std::max<int64_t>(
+        std::clamp(tick - window / 2, hi - window + 1, lo), 0);
+
+    // Only ticks new to the window need their (empty) slots repriced
+    if (base_tick_ > old_base) {
+      reprice_ticks(std::max(old_base + window, base_tick_),
+                    base_tick_ + window);
+    } else {
+      reprice_ticks(base_tick_, std::min(old_base, base_tick_ + window));
+    }
+    ++recenter_count_;
+    return true;
+  }
+
+  void reprice_ticks(int64_t first, int64_t last) noexcept {
+    for (int64_t tick = first; tick < last; ++tick) {
+      bid_levels_[slot_of_tick(tick)].reprice(tick * tick_size_);
+      ask_levels_[slot_of_tick(tick)].reprice(tick * tick_size_);
+    }
+  }
+
+  // ── Hot: touched by every message routed to this book ──
+  std::size_t best_bid_idx_ = NO_LEVEL;
+  std::size_t best_ask_idx_ = NO_LEVEL;
+  OrderIdMap *ids_; // Non-owning; points at owned_ids_ or a shared map
+  ExecutionSink *executions_ = nullptr; // Non-owning; nullptr = no reports
+  MarketDataSink *market_data_ = nullptr; // Non-owning; nullptr = no L2 feed
+  OrderFeedSink *order_feed_ = nullptr; // Non-owning; nullptr = no L3 feed
+  TopOfBookCell *top_ = nullptr;        // Non-owning; nullptr = no L1 cell
+  DepthCacheCell *depth_ = nullptr;     // Non-owning; nullptr = no depth cell
+  IntrusiveOrderList *graveyard_ = nullptr; // Non-owning; dead orders
+  uint16_t instrument_id_ = 0;          // tags this book's level deltas
+  Side aggressor_side_ = Side::BID;     // Side of the most recent add
+  bool auction_ = false;                // call phase: cross()/match() idle
+  bool top_stale_ = false; // levels changed since publish_top/depth()
+  int64_t tick_size_;
+  int64_t base_tick_ = 0; // Lowest tick in the window
+  int64_t last_trade_price_ = 0;             // 0 = no trade yet
+  std::size_t next_buy_stop_idx_ = NO_LEVEL; // lowest buy trigger
+  std::size_t next_sell_stop_idx_ = NO_LEVEL; // highest sell trigger
+
+  std::vector<PriceLevel> bid_levels_;
+  std::vector<PriceLevel> ask_levels_;
+  // Structure-of-arrays shadow of each level's total_qty(), same ring slots:
+  // what snapshot() copies, with no list pointers in between
+  std::vector<uint32_t> bid_depth_;
+  std::vector<uint32_t> ask_depth_;
+  LevelBitmap bid_occupied_;
+  LevelBitmap ask_occupied_;
+
+  // ── Trigger index: parked stops by trigger tick, same ring slots ──
+  std::vector<IntrusiveOrderList> buy_stops_;
+  std::vector<IntrusiveOrderList> sell_stops_;
+  LevelBitmap buy_stop_occupied_;
+  LevelBitmap sell_stop_occupied_;
+
+  uint64_t match_count_ = 0;
+  uint64_t cancel_count_ = 0;
+  uint64_t replace_count_ = 0;
+  uint64_t recenter_count_ = 0;
+  uint64_t stops_triggered_ = 0;
+  uint64_t auctions_uncrossed_ = 0;
+
+  // ── Idle sweep cursor (compact_step) ──
+  std::size_t sweep_slot_ = 0;
+  bool sweep_asks_ = false;
+
+  // ── Cold: only set for standalone books ──
+  std::unique_ptr<OrderIdMap> owned_ids_;
+
+  // ── Cold: views last written to top_ / depth_, and where to report
+  // staleness ──
+  TopOfBook published_;
+  ConflatedDepth published_depth_;
+  std::vector<BasicOrderBook *> *stale_tops_ = nullptr;
+
+  // ── Cold: call auction search scratch, allocated by begin_auction() ──
+  static_assert(WINDOW % auction::BLOCK == 0, "Window pads to whole blocks");
+  struct AuctionScratch {
+    std::array<double, WINDOW> bids; // per tick, then the demand curve
+    std::array<double, WINDOW> asks; // per tick, then the supply curve
+  };
+  std::unique_ptr<AuctionScratch> auction_scratch_;
+};
+
+/// Price-time FIFO book: what InstrumentDirectory and the matchers run.
+using OrderBook = BasicOrderBook<PriceTimePriority>;
+/// Pro-rata book with top-of-queue priority.
+using ProRataOrderBook = BasicOrderBook<ProRata>;
+
+// ═══════════════════════════════════════════════════════════════════════
+//  23. INSTRUMENT DIRECTORY — instrument_id -> dense book slot
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Maps Order::instrument_id to a dense slot and owns one OrderBook per slot.
+///
+/// Design:
+///   - Direct-mapped uint16_t slot table over [0, INSTRUMENT_ID_SPACE):
+///   lookup is a single load, 32 instrument IDs per cache line
+///   - Books stored contiguously in slot order; capacity reserved up front so
+///   registration never relocates a live book
+///   - Instruments are registered at startup (cold path). Orders for unknown
+///   instruments are rejected rather than allocating a book on the hot path
+///   - One OrderIdMap shared by all books: CANCEL messages carry only an
+///   order ID, so the map resolves the order and its instrument in one hop
+///   - One graveyard shared by all books; reclaim() returns its dead orders
+///   to the ObjectPool a bounded batch at a time
+///   - compact() sweeps the books round-robin for dead orders left on their
+///   levels, a bounded amount of work per call
+///   - Orders entered through submit_limit() or submit_stop() join their
+///   owner's chain in an OwnerIndex (once track_owners() is called) and leave
+///   it on reclaim, so mass_cancel() touches only that owner's orders
+///   - One TopOfBookCell and one DepthCacheCell per slot: flush_market_data()
+///   republishes the L1 and conflated depth of the books the last message
+///   touched, for readers on any thread
+///
+/// Complexity: find O(1), cancel O(1), mass_cancel O(owner's orders)
+class InstrumentDirectory {
+public:
+  static constexpr uint16_t INVALID_SLOT = 0xFFFF;
+  static_assert(config::MAX_INSTRUMENTS < INVALID_SLOT,
+                "Instrument slots must fit in uint16_t");
+
+  /// `max_live_orders` sizes the shared ID index: the most orders that can be
+  /// mapped at once, i.e. the capacity of the pool feeding this directory.
+  explicit InstrumentDirectory(std::size_t max_live_orders = config::MAX_ORDERS)
+      : slot_of_(config::INSTRUMENT_ID_SPACE, INVALID_SLOT),
+        ids_(max_live_orders), touched_(config::MAX_INSTRUMENTS, 0),
+        tops_(config::MAX_INSTRUMENTS), depths_(config::MAX_INSTRUMENTS) {
+    books_.reserve(config::MAX_INSTRUMENTS);
+    touched_books_.reserve(config::MAX_INSTRUMENTS);
+    stale_tops_.reserve(config::MAX_INSTRUMENTS);
+  }
+
+  // ─────────── Non-copyable, non-movable (books hold &ids_) ───────────
+
+  InstrumentDirectory(const InstrumentDirectory &) = delete;
+  InstrumentDirectory &operator=(const InstrumentDirectory &) = delete;
+  InstrumentDirectory(InstrumentDirectory &&) = delete;
+  InstrumentDirectory &operator=(InstrumentDirectory &&) = delete;
+
+  // ─────────── API ───────────
+
+  /// Register an instrument and create its book. NOT on the hot path.
+  /// Returns the dense slot, or INVALID_SLOT if the ID is out of range or
+  /// the directory is full. Registering twice returns the existing slot.
+  uint16_t add_instrument(uint64_t instrument_id,
+                          int64_t tick_size = config::DEFAULT_TICK_SIZE,
+                          int64_t reference_price = config::MID_PRICE) {
+    if (instrument_id >= config::INSTRUMENT_ID_SPACE) [[unlikely]]
+      return INVALID_SLOT;
+    if (slot_of_[instrument_id] != INVALID_SLOT)
+      return slot_of_[instrument_id];
+    if (books_.size() >= config::MAX_INSTRUMENTS) [[unlikely]]
+      return INVALID_SLOT;
+
+    auto slot = static_cast<uint16_t>(books_.size());
+    books_.emplace_back(&ids_, tick_size, reference_price);
+    books_.back().set_execution_sink(executions_);
+    books_.back().set_market_data_sink(market_data_,
+                                       static_cast<uint16_t>(instrument_id));
+    books_.back().set_order_feed_sink(order_feed_);
+    books_.back().set_graveyard(&graveyard_);
+    books_.back().set_top_of_book(&tops_[slot], &stale_tops_);
+    books_.back().set_depth_cache(&depths_[slot]);
+    slot_of_[instrument_id] = slot;
+    return slot;
+  }
+
+  /// Route fills of every book, present and future, to `sink`.
+  void set_execution_sink(ExecutionSink *sink) noexcept {
+    executions_ = sink;
+    for (auto &book : books_)
+      book.set_execution_sink(sink);
+  }
+
+  /// Route level deltas of every book, present and future, to `sink`.
+  /// NOT on the hot path: walks the instrument ID table.
+  void set_market_data_sink(MarketDataSink *sink) noexcept {
+    market_data_ = sink;
+    for (std::size_t id = 0; id < slot_of_.size(); ++id) {
+      if (slot_of_[id] != INVALID_SLOT)
+        books_[slot_of_[id]].set_market_data_sink(sink,
+                                                  static_cast<uint16_t>(id));
+    }
+  }
+
+  /// Route L3 order events of every book, present and future, to `sink`.
+  void set_order_feed_sink(OrderFeedSink *sink) noexcept {
+    order_feed_ = sink;
+    for (auto &book : books_)
+      book.set_order_feed_sink(sink);
+  }
+
+  /// Publish what the message just processed changed: the level deltas if
+  /// a feed is attached, then the L1 and depth cells of each book it
+  /// touched, stamped with the delta sequence they reflect.
+  /// O(levels it changed + books * CONFLATED_DEPTH).
+  void flush_market_data() noexcept {
+    uint64_t feed_sequence = 0;
+    if (market_data_) {
+      market_data_->flush();
+      feed_sequence = market_data_->sequence();
+    }
+    for (OrderBook *book : stale_tops_) {
+      book->publish_top();
+      book->publish_depth(feed_sequence);
+    }
+    stale_tops_.clear();
+  }
+
+  /// Full-depth image of an instrument's book, stamped with the L2 feed
+  /// sequence it is current at. Call between messages, on the matcher
+  /// thread. Returns false if the instrument is unregistered.
+  bool snapshot(uint64_t instrument_id, BookSnapshot &out) noexcept {
+    OrderBook *book = find(instrument_id);
+    if (!book)
+      return false;
+    book->snapshot(out);
+    out.sequence = market_data_ ? market_data_->sequence() : 0;
+    return true;
+  }
+
+  /// L1 cell of an instrument, or nullptr if unregistered. The cell may be
+  /// read from any thread; register instruments before sharing it. O(1).
+  [[nodiscard]] const TopOfBookCell *
+  top_of_book(uint64_t instrument_id) const noexcept {
+    if (instrument_id >= config::INSTRUMENT_ID_SPACE) [[unlikely]]
+      return nullptr;
+    uint16_t slot = slot_of_[instrument_id];
+    return (slot != INVALID_SLOT) ? &tops_[slot] : nullptr;
+  }
+
+  /// Conflated depth cell of an instrument, or nullptr if unregistered. Same
+  /// sharing rules as top_of_book(). O(1).
+  [[nodiscard]] const DepthCacheCell *
+  depth_cache(uint64_t instrument_id) const noexcept {
+    if (instrument_id >= config::INSTRUMENT_ID_SPACE) [[unlikely]]
+      return nullptr;
+    uint16_t slot = slot_of_[instrument_id];
+    return (slot != INVALID_SLOT) ? &depths_[slot] : nullptr;
+  }
+
+  /// Book for an instrument, or nullptr if unregistered. O(1).
+  [[nodiscard]] OrderBook *find(uint64_t instrument_id) noexcept {
+    if (instrument_id >= config::INSTRUMENT_ID_SPACE) [[unlikely]]
+      return nullptr;
+    uint16_t slot = slot_of_[instrument_id];
+    return (slot != INVALID_SLOT) ? &books_[slot] : nullptr;
+  }
+
+  /// Chain orders from `pool` by owner from now on. Call before the first
+  /// submit_limit(); the pool must outlive the directory. NOT on the hot path.
+  template <typename Pool> void track_owners(Pool &pool) {
+    owners_.attach(pool.data(), pool.capacity());
+  }
+
+  /// OrderBook::submit_limit() on `book`, chaining an accepted order to its
+  /// owner. Returns the filled quantity or OrderBook::REJECTED.
+  uint64_t submit_limit(OrderBook &book, Order *order) {
+    uint64_t filled = book.submit_limit(order);
+    if (filled != OrderBook::REJECTED)
+      owners_.link(order);
+    return filled;
+  }
+
+  /// OrderBook::submit_stop() on `book`, chaining an accepted stop to its
+  /// owner. Returns the filled quantity or OrderBook::REJECTED.
+  uint64_t submit_stop(OrderBook &book, Order *order, int64_t trigger_price) {
+    uint64_t filled = book.submit_stop(order, trigger_price);
+    if (filled != OrderBook::REJECTED)
+      owners_.link(order);
+    return filled;
+  }
+
+  /// Cancel an order by ID, routed to its instrument's book. O(1).
+  bool cancel_order(uint64_t order_id) {
+    Order *order = ids_.find(order_id);
+    if (!order)
+      return false;
+    OrderBook *book = find(order->instrument_id);
+    return book && book->cancel_order(order_id);
+  }
+
+  /// Amend an order by ID, routed to its instrument's book. O(1) plus any
+  /// fills. Returns the filled quantity or OrderBook::REJECTED.
+  uint64_t replace_order(uint64_t order_id, int64_t new_price,
+                         uint32_t new_qty) {
+    Order *order = ids_.find(order_id);
+    if (!order)
+      return OrderBook::REJECTED;
+    OrderBook *book = find(order->instrument_id);
+    return book ? book->replace_order(order_id, new_price, new_qty)
+                : OrderBook::REJECTED;
+  }
+
+  /// Cancel every live order `owner_id` has in any book (session logout or
+  /// disconnect). Other owners' orders are never visited; each book touched
+  /// re-derives its best prices once, at the end. Returns how many orders
+  /// were cancelled.
+  std::size_t mass_cancel(uint32_t owner_id) {
+    std::size_t cancelled = 0;
+    owners_.for_each(owner_id, [&](Order *order) {
+      if (!order->active)
+        return; // filled or cancelled, waiting for reclaim
+      OrderBook *book = find(order->instrument_id);
+      if (!book) [[unlikely]]
+        return;
+      auto slot = static_cast<std::size_t>(book - books_.data());
+      if (!touched_[slot]) {
+        touched_[slot] = 1;
+        touched_books_.push_back(book);
+      }
+      book->withdraw(order);
+      ++cancelled;
+    });
+
+    for (OrderBook *book : touched_books_) {
+      book->refresh_best();
+      touched_[static_cast<std::size_t>(book - books_.data())] = 0;
+    }
+    touched_books_.clear();
+    return cancelled;
+  }
+
+  /// Return up to `budget` dead orders to `pool`. Returns how many were
+  /// freed. Bounded work: call it from the matcher loop, never in a burst.
+  template <RecyclerOf<Order> Pool>
+  std::size_t reclaim(Pool &pool, std::size_t budget) noexcept {
+    std::size_t freed = 0;
+    while (freed < budget) {
+      Order *order = graveyard_.pop_front();
+      if (!order)
+        break;
+      if (ids_.find(order->id) == order) // filled orders are still mapped
+        ids_.erase(order->id);
+      owners_.unlink(order);
+      pool.release(order);
+      ++freed;
+    }
+    return freed;
+  }
+
+  /// Advance the idle sweep by at most `budget` units of work, book after
+  /// book, resuming where the last call stopped (one unit per book passed,
+  /// see OrderBook::compact_step for the rest). Swept orders join the
+  /// graveyard; returns how many.
+  std::size_t compact(std::size_t budget) noexcept {
+    std::size_t before = graveyard_.size();
+    while (budget > 0 && !books_.empty() &&
+           books_[sweep_book_].compact_step(budget)) {
+      sweep_book_ = (sweep_book_ + 1) % books_.size();
+      budget -= std::min<std::size_t>(budget, 1);
+    }
+    return graveyard_.size() - before;
+  }
 
-} // namespace platform
+  // ─────────── Accessors ───────────
+
+  [[nodiscard]] std::size_t size() const noexcept { return books_.size(); }
+  [[nodiscard]] std::size_t pending_reclaim() const noexcept {
+    return graveyard_.size();
+  }
+  [[nodiscard]] OrderBook &book_at(uint16_t slot) noexcept {
+    return books_[slot];
+  }
+
+private:
+  std::vector<uint16_t> slot_of_; // instrument_id -> slot (INVALID_SLOT = none)
+  std::vector<OrderBook> books_;  // dense, indexed by slot
+  OrderIdMap ids_;                // shared by all books
+  IntrusiveOrderList graveyard_;  // dead orders awaiting reclaim()
+  OwnerIndex owners_;             // owner_id -> that owner's orders
+  std::vector<uint8_t> touched_;  // slot -> touched by this mass_cancel()
+  std::vector<OrderBook *> touched_books_;
+  std::vector<TopOfBookCell> tops_;      // slot -> L1 cell, any thread reads
+  std::vector<DepthCacheCell> depths_;   // slot -> conflated depth cell
+  std::vector<OrderBook *> stale_tops_;  // books whose L1 may have changed
+  ExecutionSink *executions_ = nullptr;
+  MarketDataSink *market_data_ = nullptr;
+  OrderFeedSink *order_feed_ = nullptr;
+  std::size_t sweep_book_ = 0;    // compact() resumes at this book
+};
 
 // ═══════════════════════════════════════════════════════════════════════
-//  11. ENGINE STATISTICS — Atomic counters for cross-thread reporting
+//  24. ENGINE STATISTICS — Atomic counters for cross-thread reporting
 // ═══════════════════════════════════════════════════════════════════════
 
 struct alignas(config::CACHE_LINE_SIZE) EngineStats {
@@ -860,11 +4108,19 @@ struct alignas(config::CACHE_LINE_SIZE) EngineStats {
   std::atomic<uint64_t> total_fills{0};
   std::atomic<uint64_t> ring_buffer_full_count{0};
   std::atomic<uint64_t> pool_exhausted_count{0};
+  std::atomic<uint64_t> unknown_instrument_count{0};
+  std::atomic<uint64_t> add_reject_count{0};
+  std::atomic<uint64_t> execution_stall_count{0};
+  std::atomic<uint64_t> market_data_drop_count{0};
+  std::atomic<uint64_t> order_feed_drop_count{0};
+  std::atomic<uint64_t> orders_reclaimed{0};
+  std::atomic<uint64_t> orders_swept{0};
+  std::atomic<uint64_t> orders_mass_cancelled{0};
   std::atomic<bool> running{true};
 };
 
 // ═══════════════════════════════════════════════════════════════════════
-//  12. MATCHER THREAD — Pinned busy-spin event loop
+//  25. MATCHER THREAD — Pinned busy-spin event loop
 // ═══════════════════════════════════════════════════════════════════════
 
 /// The core matching engine loop.
@@ -872,17 +4128,37 @@ struct alignas(config::CACHE_LINE_SIZE) EngineStats {
 /// Design:
 ///   - Pinned to a dedicated CPU core (no context switches)
 ///   - Busy-spin: no sleep(), no yield() — minimum latency
-///   - All memory from pre-allocated ObjectPool (zero heap alloc)
-///   - Processes OrderMessages from the SPSC ring buffer
+///   - All memory from a pre-allocated ConcurrentObjectPool (zero heap
+///   alloc); the matcher only releases, through its own Cache
+///   - Filled and cancelled limit orders go back to the pool, at most
+///   RECLAIM_BATCH per loop iteration, so a long session runs in constant
+///   memory without a reclamation burst ever delaying a live order
+///   - Processes OrderMessages from the MPSC ring buffer (any number of
+///   gateway threads) in place: peek() the slot, process it, release() it.
+///   No copy out of the ring, and the gateway built the message in the slot
+///   too. Up to MATCHER_BATCH per pass, each processed, flushed and followed
+///   by a reclaim step on its own
+///   - One OrderBook per instrument via InstrumentDirectory; instruments must
+///   be registered through instruments() before the thread starts
 ///
-/// Hot path: pop() -> dispatch -> add/cancel/match -> stats update
+/// Hot path: per message: peek() -> find book -> add/cancel/match ->
+/// release() -> flush level deltas -> reclaim; stats update once per batch.
+/// Stops a trade sets off run inside that same message
 /// Expected latency per order: < 1 microsecond
 class MatcherThread {
 public:
-  MatcherThread(LockFreeRingBuffer<OrderMessage> &ring_buffer,
-                ObjectPool<Order> &order_pool, EngineStats &stats, int core_id)
+  MatcherThread(MpscRingBuffer<OrderMessage> &ring_buffer,
+                ConcurrentObjectPool<Order> &order_pool, EngineStats &stats,
+                int core_id)
       : ring_buffer_(ring_buffer), order_pool_(order_pool), stats_(stats),
-        core_id_(core_id) {}
+        core_id_(core_id), instruments_(order_pool.capacity()) {
+    instruments_.track_owners(order_pool);
+  }
+
+  /// Instrument registry. Populate before launching the thread.
+  [[nodiscard]] InstrumentDirectory &instruments() noexcept {
+    return instruments_;
+  }
 
   /// Main entry point — runs until stats_.running becomes false.
   void operator()() {
@@ -895,190 +4171,635 @@ public:
     }
 
     // ── Step 2: Busy-spin event loop ──
-    OrderMessage msg{};
-    uint64_t loop_count = 0;
-    constexpr uint64_t COMPACT_INTERVAL = 100'000;
-
     while (stats_.running.load(std::memory_order_relaxed)) {
-      if (ring_buffer_.pop(msg)) {
-        process_message(msg);
-        stats_.orders_processed.fetch_add(1, std::memory_order_relaxed);
+      if (drain_batch() == 0) {
+        // Idle poll: a bounded slice of the level sweep, so a message that
+        // lands now waits at most COMPACT_BUDGET steps
+        sweep(config::COMPACT_BUDGET);
+        reclaim(config::RECLAIM_BATCH);
       }
       // No sleep, no yield — pure busy-spin for minimum latency
-
-      // Periodic maintenance (not on critical path)
-      ++loop_count;
-      if ((loop_count & (COMPACT_INTERVAL - 1)) == 0) [[unlikely]] {
-        // Could do periodic level compaction here
-        // book_.compact() — omitted for hot-path purity
-      }
     }
 
     // ── Step 3: Drain remaining messages ──
-    while (ring_buffer_.pop(msg)) {
-      process_message(msg);
-      stats_.orders_processed.fetch_add(1, std::memory_order_relaxed);
+    while (drain_batch() > 0) {
+    }
+    while (reclaim(config::RECLAIM_BATCH) > 0) {
     }
   }
 
 private:
+  /// Process up to MATCHER_BATCH messages in order, each straight from its
+  /// ring slot. Returns how many there were.
+  std::size_t drain_batch() {
+    std::size_t n = 0;
+    for (; n < config::MATCHER_BATCH; ++n) {
+      const OrderMessage *msg = ring_buffer_.peek();
+      if (!msg)
+        break;
+      process_message(*msg);
+      ring_buffer_.release(); // slot free before the flush and reclaim
+      instruments_.flush_market_data();
+      reclaim(config::RECLAIM_BATCH);
+    }
+    if (n > 0)
+      stats_.orders_processed.fetch_add(n, std::memory_order_relaxed);
+    return n;
+  }
+
   void process_message(const OrderMessage &msg) {
     switch (msg.type) {
     case OrderType::LIMIT: {
-      book_.add_order(msg.order);
-      uint64_t fills = book_.match();
+      OrderBook *book = instruments_.find(msg.order->instrument_id);
+      if (!book) [[unlikely]] {
+        reject(msg.order, stats_.unknown_instrument_count);
+        break;
+      }
+      uint64_t fills = instruments_.submit_limit(*book, msg.order);
+      if (fills == OrderBook::REJECTED) [[unlikely]] {
+        reject(msg.order, stats_.add_reject_count);
+        break;
+      }
+      if (fills > 0) {
+        stats_.total_fills.fetch_add(fills, std::memory_order_relaxed);
+      }
+      break;
+    }
+    case OrderType::STOP:
+    case OrderType::STOP_LIMIT: {
+      OrderBook *book = instruments_.find(msg.order->instrument_id);
+      if (!book) [[unlikely]] {
+        reject(msg.order, stats_.unknown_instrument_count);
+        break;
+      }
+      uint64_t fills = instruments_.submit_stop(*book, msg.order, msg.price);
+      if (fills == OrderBook::REJECTED) [[unlikely]] {
+        reject(msg.order, stats_.add_reject_count);
+        break;
+      }
       if (fills > 0) {
         stats_.total_fills.fetch_add(fills, std::memory_order_relaxed);
       }
       break;
     }
     case OrderType::MARKET: {
-      uint64_t fills = book_.match_market(msg.order);
+      OrderBook *book = instruments_.find(msg.order->instrument_id);
+      if (!book) [[unlikely]] {
+        reject(msg.order, stats_.unknown_instrument_count);
+        break;
+      }
+      uint64_t fills = book->match_market(msg.order);
       stats_.total_fills.fetch_add(fills, std::memory_order_relaxed);
       // Market orders are fully processed, release back to pool
       order_pool_.release(msg.order);
       break;
     }
     case OrderType::CANCEL: {
-      book_.cancel_order(msg.cancel_id);
+      instruments_.cancel_order(msg.target_id);
+      break;
+    }
+    case OrderType::REPLACE: {
+      uint64_t fills =
+          instruments_.replace_order(msg.target_id, msg.price, msg.new_qty);
+      if (fills != OrderBook::REJECTED && fills > 0)
+        stats_.total_fills.fetch_add(fills, std::memory_order_relaxed);
+      break;
+    }
+    case OrderType::MASS_CANCEL: {
+      std::size_t cancelled = instruments_.mass_cancel(
+          static_cast<uint32_t>(msg.target_id));
+      stats_.orders_mass_cancelled.fetch_add(cancelled,
+                                             std::memory_order_relaxed);
       break;
     }
     }
   }
 
-  LockFreeRingBuffer<OrderMessage> &ring_buffer_;
-  ObjectPool<Order> &order_pool_;
+  /// Move dead orders still on their levels to the graveyard, within budget.
+  void sweep(std::size_t budget) noexcept {
+    std::size_t swept = instruments_.compact(budget);
+    if (swept > 0)
+      stats_.orders_swept.fetch_add(swept, std::memory_order_relaxed);
+  }
+
+  /// Return a bounded batch of dead orders to the pool.
+  std::size_t reclaim(std::size_t budget) noexcept {
+    std::size_t freed = instruments_.reclaim(order_pool_, budget);
+    if (freed > 0)
+      stats_.orders_reclaimed.fetch_add(freed, std::memory_order_relaxed);
+    return freed;
+  }
+
+  /// Order the engine cannot accept: count it and recycle the slot.
+  void reject(Order *order, std::atomic<uint64_t> &counter) noexcept {
+    counter.fetch_add(1, std::memory_order_relaxed);
+    order_pool_.release(order);
+  }
+
+  MpscRingBuffer<OrderMessage> &ring_buffer_;
+  ConcurrentObjectPool<Order>::Cache order_pool_; // matcher-side cache
   EngineStats &stats_;
   int core_id_;
-  OrderBook book_;
+  InstrumentDirectory instruments_;
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+//  26. MATCHER SHARD — One core, one ring, one pool, one set of books
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Instrument -> shard partition. Shared by the gateway (routing) and by
+/// shard setup (registration), so both sides always agree.
+[[nodiscard]] inline std::size_t shard_of(uint64_t instrument_id,
+                                          std::size_t shard_count) noexcept {
+  return static_cast<std::size_t>(instrument_id % shard_count);
+}
+
+/// Everything a single matcher core owns. Nothing is shared across shards:
+/// each has its own arena (first-touched by setup, not by another matcher),
+/// pool, inbound ring, outbound execution, L2 and L3 rings, stats line and
+/// InstrumentDirectory.
+///
+/// Design:
+///   - Instruments are partitioned with shard_of(); a shard only registers
+///   the instruments it owns, so a misrouted order is rejected, not matched
+///   - Arena sized exactly for the pool + ring (no 64 MB default per shard)
+///   - Scaling is limited only by the gateways and by memory bandwidth
+struct MatcherShard {
+  MatcherShard(std::size_t pool_slots, int core_id)
+      : arena(arena_bytes(pool_slots)), pool(arena, pool_slots), ring(arena),
+        executions(arena), market_data(arena), order_feed(arena),
+        sink(executions, stats.execution_stall_count),
+        md_sink(market_data, stats.market_data_drop_count),
+        l3_sink(order_feed, stats.order_feed_drop_count),
+        matcher(ring, pool, stats, core_id) {
+    matcher.instruments().set_execution_sink(&sink);
+    matcher.instruments().set_market_data_sink(&md_sink);
+    matcher.instruments().set_order_feed_sink(&l3_sink);
+  }
+
+  MatcherShard(const MatcherShard &) = delete;
+  MatcherShard &operator=(const MatcherShard &) = delete;
+
+  /// Register every instrument in [0, instrument_count) owned by this shard.
+  void register_instruments(std::size_t shard_index, std::size_t shard_count,
+                            std::size_t instrument_count) {
+    for (std::size_t i = 0; i < instrument_count; ++i) {
+      if (shard_of(i, shard_count) == shard_index)
+        matcher.instruments().add_instrument(i);
+    }
+  }
+
+  [[nodiscard]] static std::size_t arena_bytes(std::size_t pool_slots) {
+    return ConcurrentObjectPool<Order>::arena_bytes(pool_slots) +
+           MpscRingBuffer<OrderMessage>::arena_bytes() +
+           config::RING_BUFFER_CAPACITY * sizeof(ExecutionReport) +
+           config::RING_BUFFER_CAPACITY * sizeof(LevelDelta) +
+           config::RING_BUFFER_CAPACITY * sizeof(OrderEvent) +
+           6 * config::CACHE_LINE_SIZE; // alignment slack
+  }
+
+  MemoryArena arena;
+  ConcurrentObjectPool<Order> pool; // gateway acquires, matcher releases
+  MpscRingBuffer<OrderMessage> ring;             // gateways -> matcher
+  LockFreeRingBuffer<ExecutionReport> executions; // matcher -> consumer
+  LockFreeRingBuffer<LevelDelta> market_data;     // matcher -> L2 feed
+  LockFreeRingBuffer<OrderEvent> order_feed;      // matcher -> L3 feed
+  EngineStats stats;
+  ExecutionSink sink;
+  MarketDataSink md_sink;
+  OrderFeedSink l3_sink;
+  MatcherThread matcher;
+};
+
+/// Gateway-side view of one shard.
+struct ShardLink {
+  MpscRingBuffer<OrderMessage> *ring;
+  ConcurrentObjectPool<Order> *pool;
+  EngineStats *stats;
+};
+
+// ═══════════════════════════════════════════════════════════════════════
+//  27. OUTBOUND CONSUMERS — Drain fills and market data off the matchers
+// ═══════════════════════════════════════════════════════════════════════
+
+/// Single consumer thread for the outbound ExecutionReport rings of every
+/// shard (each ring stays SPSC: one matcher pushes, this thread pops).
+///
+/// Stands in for the downstream drop-copy / clearing feed: it tallies
+/// reports and quantity so the report can cross-check them against the
+/// matchers' fill counters. Stop it only after the matchers have exited;
+/// it drains every ring before returning.
+class ExecutionConsumer {
+public:
+  explicit ExecutionConsumer(
+      std::vector<LockFreeRingBuffer<ExecutionReport> *> rings)
+      : rings_(std::move(rings)) {}
+
+  void operator()() {
+    ExecutionReport report{};
+    while (running_.load(std::memory_order_acquire)) {
+      for (auto *ring : rings_) {
+        while (ring->pop(report))
+          consume(report);
+      }
+    }
+    for (auto *ring : rings_) {
+      while (ring->pop(report))
+        consume(report);
+    }
+  }
+
+  void stop() noexcept { running_.store(false, std::memory_order_release); }
+
+  [[nodiscard]] uint64_t report_count() const noexcept { return reports_; }
+  [[nodiscard]] uint64_t executed_qty() const noexcept { return quantity_; }
+
+private:
+  void consume(const ExecutionReport &report) noexcept {
+    ++reports_;
+    quantity_ += report.quantity;
+  }
+
+  std::vector<LockFreeRingBuffer<ExecutionReport> *> rings_;
+  std::atomic<bool> running_{true};
+  uint64_t reports_ = 0;  // Read after join() only
+  uint64_t quantity_ = 0;
+};
+
+/// Single consumer thread for the outbound market-data rings of every
+/// shard: L2 LevelDelta and L3 OrderEvent.
+///
+/// Stands in for the feed handlers: it checks each ring's sequence for
+/// gaps (records the matcher dropped rather than wait for it), which a real
+/// feed would answer with a snapshot. Same lifecycle as ExecutionConsumer.
+class MarketDataConsumer {
+public:
+  MarketDataConsumer(std::vector<LockFreeRingBuffer<LevelDelta> *> l2_rings,
+                     std::vector<LockFreeRingBuffer<OrderEvent> *> l3_rings)
+      : l2_(std::move(l2_rings)), l3_(std::move(l3_rings)) {}
+
+  void operator()() {
+    while (running_.load(std::memory_order_acquire)) {
+      l2_.drain();
+      l3_.drain();
+    }
+    l2_.drain();
+    l3_.drain();
+  }
+
+  void stop() noexcept { running_.store(false, std::memory_order_release); }
+
+  [[nodiscard]] uint64_t delta_count() const noexcept { return l2_.records; }
+  /// Deltas missing from the sequence (dropped by a matcher on a full ring).
+  [[nodiscard]] uint64_t gap_count() const noexcept { return l2_.gaps; }
+  [[nodiscard]] uint64_t event_count() const noexcept { return l3_.records; }
+  /// L3 events missing from the sequence.
+  [[nodiscard]] uint64_t event_gap_count() const noexcept { return l3_.gaps; }
+
+private:
+  /// One ring per shard of a sequenced record type, with gap accounting.
+  template <typename Record> struct Feed {
+    explicit Feed(std::vector<LockFreeRingBuffer<Record> *> feed_rings)
+        : rings(std::move(feed_rings)), next_sequence(rings.size(), 1) {}
+
+    void drain() noexcept {
+      Record record{};
+      for (std::size_t i = 0; i < rings.size(); ++i) {
+        while (rings[i]->pop(record)) {
+          ++records;
+          gaps += record.sequence - next_sequence[i];
+          next_sequence[i] = record.sequence + 1;
+        }
+      }
+    }
+
+    std::vector<LockFreeRingBuffer<Record> *> rings;
+    std::vector<uint64_t> next_sequence; // per ring: sequence expected next
+    uint64_t records = 0;                // Read after join() only
+    uint64_t gaps = 0;
+  };
+
+  Feed<LevelDelta> l2_;
+  Feed<OrderEvent> l3_;
+  std::atomic<bool> running_{true};
+};
+
+/// A deliberately slow subscriber to the conflated depth cache: every
+/// SLOW_SUBSCRIBER_PERIOD_US it reads each instrument's DepthCacheCell once.
+///
+/// It shows what the cache is for: however long it sleeps, each read is the
+/// latest image and the matchers never wait for it. Updates it missed in
+/// between are counted from the cell sequence as conflated. Stop it after
+/// the matchers have exited; its last pass reads the final state.
+class DepthCacheSubscriber {
+public:
+  explicit DepthCacheSubscriber(std::vector<const DepthCacheCell *> cells)
+      : cells_(std::move(cells)), last_sequence_(cells_.size(), 0) {}
+
+  void operator()() {
+    while (running_.load(std::memory_order_acquire)) {
+      poll();
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(config::SLOW_SUBSCRIBER_PERIOD_US));
+    }
+    poll();
+  }
+
+  void stop() noexcept { running_.store(false, std::memory_order_release); }
+
+  [[nodiscard]] uint64_t read_count() const noexcept { return reads_; }
+  /// Updates seen: reads that found a newer image than the previous one.
+  [[nodiscard]] uint64_t update_count() const noexcept { return updates_; }
+  /// Updates overwritten before this subscriber got to read them.
+  [[nodiscard]] uint64_t conflated_count() const noexcept {
+    return conflated_;
+  }
+
+private:
+  void poll() noexcept {
+    for (std::size_t i = 0; i < cells_.size(); ++i) {
+      ConflatedDepth depth = cells_[i]->read();
+      ++reads_;
+      if (depth.sequence == last_sequence_[i])
+        continue;
+      ++updates_;
+      conflated_ += depth.sequence - last_sequence_[i] - 1;
+      last_sequence_[i] = depth.sequence;
+    }
+  }
+
+  std::vector<const DepthCacheCell *> cells_;
+  std::vector<uint64_t> last_sequence_; // per cell: sequence last read
+  std::atomic<bool> running_{true};
+  uint64_t reads_ = 0; // Read after join() only
+  uint64_t updates_ = 0;
+  uint64_t conflated_ = 0;
 };
 
 // ═══════════════════════════════════════════════════════════════════════
-//  13. GATEWAY SIMULATOR — Synthetic order generator (Producer)
+//  28. GATEWAY SIMULATOR — Synthetic order generator (Producer)
 // ═══════════════════════════════════════════════════════════════════════
 
 /// Simulates an order gateway feeding the matching engine.
 ///
 /// Generates realistic order flow:
-///   - 70% Limit orders (normal price distribution around mid-price)
-///   - 20% Market orders (immediate execution)
+///   - 50% Limit orders (normal price distribution around mid-price), one
+///   in ten an iceberg showing a tenth of its size
+///   - 5% Stop / stop-limit orders (trigger drawn like a limit price)
+///   - 15% Market orders (immediate execution)
+///   - 20% Replace orders (new price and size for a previously sent order)
 ///   - 10% Cancel orders (cancel previously sent orders)
+///   - 0.01% Mass cancels (one of SIM_SESSION_COUNT sessions disconnects)
 ///   - Zipfian instrument distribution (few hot instruments)
+///
+/// Sharded mode: each order goes to shard_of(instrument_id). The gateway
+/// remembers the instrument of every ID it issued, so a CANCEL or REPLACE
+/// reaches the shard that holds the order. A session's orders may sit on
+/// any shard, so a MASS_CANCEL goes to all of them.
+///
+/// Several gateways: gateway k of n runs on its own thread and pushes into
+/// the same MPSC rings. It issues order IDs k+1, k+1+n, k+1+2n, ... and
+/// owns sessions k+1, k+1+n, ..., so IDs never collide, a gateway only
+/// cancels or replaces its own orders and a MASS_CANCEL only names its own
+/// sessions. Each gateway has its own pool caches and RNG seed.
 class GatewaySimulator {
 public:
-  GatewaySimulator(LockFreeRingBuffer<OrderMessage> &ring_buffer,
-                   ObjectPool<Order> &order_pool, EngineStats &stats,
+  GatewaySimulator(MpscRingBuffer<OrderMessage> &ring_buffer,
+                   ConcurrentObjectPool<Order> &order_pool, EngineStats &stats,
                    std::size_t total_orders)
-      : ring_buffer_(ring_buffer), order_pool_(order_pool), stats_(stats),
-        total_orders_(total_orders),
-        rng_(42) // Deterministic seed for reproducibility
-  {}
+      : GatewaySimulator({ShardLink{&ring_buffer, &order_pool, &stats}},
+                         total_orders) {}
+
+  GatewaySimulator(std::vector<ShardLink> shards, std::size_t total_orders,
+                   std::size_t gateway_index = 0,
+                   std::size_t gateway_count = 1)
+      : shards_(std::move(shards)), total_orders_(total_orders),
+        gateway_index_(gateway_index), gateway_count_(gateway_count),
+        instrument_of_id_(total_orders + 1, 0),
+        rng_(42 + gateway_index) // Deterministic seed for reproducibility
+  {
+    caches_.reserve(shards_.size());
+    for (auto &link : shards_)
+      caches_.emplace_back(*link.pool);
+  }
 
   /// Main entry point — generates and pushes orders.
   void operator()() {
     uint64_t next_id = 1;
 
     for (std::size_t i = 0; i < total_orders_; ++i) {
-      if (!stats_.running.load(std::memory_order_relaxed))
+      // All shards are stopped together; the first flag speaks for all
+      if (!shards_.front().stats->running.load(std::memory_order_relaxed))
         break;
 
       double roll = dist_uniform_(rng_);
-      OrderMessage msg{};
 
       if (roll < config::LIMIT_ORDER_RATIO) {
         // ── Limit Order ──
-        Order *order = order_pool_.acquire();
+        uint64_t instrument = dist_instrument_(rng_);
+        ShardLink &link = route(instrument);
+        Order *order = acquire_from(link);
         if (!order) [[unlikely]] {
-          stats_.pool_exhausted_count.fetch_add(1, std::memory_order_relaxed);
+          link.stats->pool_exhausted_count.fetch_add(
+              1, std::memory_order_relaxed);
           continue;
         }
-        fill_limit_order(order, next_id++);
-
-        msg.type = OrderType::LIMIT;
-        msg.order = order;
-      } else if (roll <
-                 config::LIMIT_ORDER_RATIO + config::MARKET_ORDER_RATIO) {
+        remember(next_id, instrument);
+        fill_limit_order(order, global_id(next_id++), instrument);
+        if (dist_uniform_(rng_) < config::ICEBERG_RATIO)
+          order->peak_qty = order->quantity / 10 + 1;
+
+        send(link, [order](OrderMessage &msg) {
+          msg.type = OrderType::LIMIT;
+          msg.order = order;
+        });
+      } else if (roll < config::LIMIT_ORDER_RATIO + config::STOP_ORDER_RATIO) {
+        // ── Stop / Stop-Limit Order ──
+        uint64_t instrument = dist_instrument_(rng_);
+        ShardLink &link = route(instrument);
+        Order *order = acquire_from(link);
+        if (!order) [[unlikely]] {
+          link.stats->pool_exhausted_count.fetch_add(
+              1, std::memory_order_relaxed);
+          continue;
+        }
+        remember(next_id, instrument);
+        fill_limit_order(order, global_id(next_id++), instrument);
+        order->type = (dist_uniform_(rng_) < 0.5) ? OrderType::STOP
+                                                  : OrderType::STOP_LIMIT;
+        int64_t trigger = random_limit_price();
+
+        send(link, [order, trigger](OrderMessage &msg) {
+          msg.type = order->type;
+          msg.order = order;
+          msg.price = trigger;
+        });
+      } else if (roll < config::LIMIT_ORDER_RATIO + config::STOP_ORDER_RATIO +
+                            config::MARKET_ORDER_RATIO) {
         // ── Market Order ──
-        Order *order = order_pool_.acquire();
+        uint64_t instrument = dist_instrument_(rng_);
+        ShardLink &link = route(instrument);
+        Order *order = acquire_from(link);
         if (!order) [[unlikely]] {
-          stats_.pool_exhausted_count.fetch_add(1, std::memory_order_relaxed);
+          link.stats->pool_exhausted_count.fetch_add(
+              1, std::memory_order_relaxed);
           continue;
         }
-        fill_market_order(order, next_id++);
-
-        msg.type = OrderType::MARKET;
-        msg.order = order;
-      } else {
+        remember(next_id, instrument);
+        fill_market_order(order, global_id(next_id++), instrument);
+
+        send(link, [order](OrderMessage &msg) {
+          msg.type = OrderType::MARKET;
+          msg.order = order;
+        });
+      } else if (roll < config::LIMIT_ORDER_RATIO + config::STOP_ORDER_RATIO +
+                            config::MARKET_ORDER_RATIO +
+                            config::REPLACE_ORDER_RATIO) {
+        // ── Replace Order ──
+        uint64_t target = pick_recent_id(next_id);
+        int64_t price = random_limit_price();
+        auto new_qty = static_cast<uint32_t>(dist_qty_(rng_)) + 1;
+
+        send(route(instrument_of_id_[target]), [&](OrderMessage &msg) {
+          msg.type = OrderType::REPLACE;
+          msg.target_id = global_id(target);
+          msg.price = price;
+          msg.new_qty = new_qty;
+        });
+      } else if (roll < 1.0 - config::MASS_CANCEL_RATIO) {
         // ── Cancel Order ──
-        msg.type = OrderType::CANCEL;
-        msg.cancel_id = generate_cancel_id(next_id);
-      }
+        uint64_t target = pick_recent_id(next_id);
 
-      // Push to ring buffer with back-pressure retry
-      while (!ring_buffer_.push(msg)) {
-        stats_.ring_buffer_full_count.fetch_add(1, std::memory_order_relaxed);
-        // Spin-wait: producer backs off briefly
-        std::this_thread::yield();
+        send(route(instrument_of_id_[target]), [&](OrderMessage &msg) {
+          msg.type = OrderType::CANCEL;
+          msg.target_id = global_id(target);
+        });
+      } else {
+        // ── Mass Cancel: broadcast, counted once per shard ──
+        uint32_t owner = random_owner();
+        for (auto &shard : shards_) {
+          send(shard, [owner](OrderMessage &msg) {
+            msg.type = OrderType::MASS_CANCEL;
+            msg.target_id = owner;
+          });
+        }
       }
-
-      stats_.orders_received.fetch_add(1, std::memory_order_relaxed);
     }
   }
 
 private:
-  void fill_limit_order(Order *order, uint64_t id) {
+  /// Build one message in place in the shard's ring: claim a slot (with
+  /// back-pressure retry), let `fill` set its fields, commit. Everything
+  /// random is drawn before the claim, so the slot is held only for the
+  /// stores.
+  template <typename Fill> void send(ShardLink &link, Fill &&fill) {
+    OrderMessage *slot;
+    while (!(slot = link.ring->try_claim())) {
+      link.stats->ring_buffer_full_count.fetch_add(1,
+                                                   std::memory_order_relaxed);
+      // Spin-wait: producer backs off briefly
+      std::this_thread::yield();
+    }
+    *slot = OrderMessage{};
+    fill(*slot);
+    link.ring->commit(slot);
+    link.stats->orders_received.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] ShardLink &route(uint64_t instrument_id) noexcept {
+    return shards_[shard_of(instrument_id, shards_.size())];
+  }
+
+  /// Gateway-side cache of the shard's pool (orders come back via the
+  /// matcher's cache, in whole magazines).
+  [[nodiscard]] Order *acquire_from(const ShardLink &link) noexcept {
+    return caches_[static_cast<std::size_t>(&link - shards_.data())].acquire();
+  }
+
+  /// Engine-wide ID of this gateway's `local_id`-th order (1-based).
+  [[nodiscard]] uint64_t global_id(uint64_t local_id) const noexcept {
+    return (local_id - 1) * gateway_count_ + gateway_index_ + 1;
+  }
+
+  void remember(uint64_t id, uint64_t instrument_id) noexcept {
+    instrument_of_id_[id] = static_cast<uint16_t>(instrument_id);
+  }
+
+  void fill_limit_order(Order *order, uint64_t id, uint64_t instrument_id) {
     order->id = id;
-    order->instrument_id = dist_instrument_(rng_) % 100;
+    order->instrument_id = instrument_id;
     order->side = (dist_uniform_(rng_) < 0.5) ? Side::BID : Side::ASK;
     order->type = OrderType::LIMIT;
     order->timestamp = platform::timestamp_ns();
-
-    // Price: normal distribution around mid-price
-    double price_offset = dist_price_(rng_);
-    int64_t raw_price = config::MID_PRICE + static_cast<int64_t>(price_offset);
-    order->price = std::max(raw_price, static_cast<int64_t>(1));
+    order->price = random_limit_price();
 
     // Quantity: 1-1000 units
     order->quantity = static_cast<uint32_t>(dist_qty_(rng_)) + 1;
     order->remaining_qty = order->quantity;
+    order->owner_id = random_owner();
     order->active = 1;
   }
 
-  void fill_market_order(Order *order, uint64_t id) {
+  void fill_market_order(Order *order, uint64_t id, uint64_t instrument_id) {
     order->id = id;
-    order->instrument_id = dist_instrument_(rng_) % 100;
+    order->instrument_id = instrument_id;
     order->side = (dist_uniform_(rng_) < 0.5) ? Side::BID : Side::ASK;
     order->type = OrderType::MARKET;
     order->price = 0; // Market orders have no price
     order->timestamp = platform::timestamp_ns();
     order->quantity = static_cast<uint32_t>(dist_qty_(rng_)) + 1;
     order->remaining_qty = order->quantity;
+    order->owner_id = random_owner();
     order->active = 1;
   }
 
-  [[nodiscard]] uint64_t generate_cancel_id(uint64_t current_max_id) {
+  /// Sending session: one of this gateway's share of owner IDs
+  /// 1..SIM_SESSION_COUNT.
+  [[nodiscard]] uint32_t random_owner() {
+    const std::size_t sessions = config::SIM_SESSION_COUNT / gateway_count_;
+    return static_cast<uint32_t>(1 + gateway_index_ +
+                                 gateway_count_ * (rng_() % sessions));
+  }
+
+  /// Normal distribution around mid-price, snapped to the tick grid.
+  [[nodiscard]] int64_t random_limit_price() {
+    double price_offset = dist_price_(rng_);
+    int64_t raw_price = config::MID_PRICE + static_cast<int64_t>(price_offset);
+    raw_price -= raw_price % config::DEFAULT_TICK_SIZE;
+    return std::max(raw_price, config::DEFAULT_TICK_SIZE);
+  }
+
+  /// Target for a CANCEL or REPLACE: any local ID issued so far.
+  [[nodiscard]] uint64_t pick_recent_id(uint64_t current_max_id) {
     if (current_max_id <= 1)
       return 1;
-    // Cancel a random recent order
+    // Pick a random recent order
     auto range = std::uniform_int_distribution<uint64_t>(1, current_max_id - 1);
     return range(rng_);
   }
 
-  LockFreeRingBuffer<OrderMessage> &ring_buffer_;
-  ObjectPool<Order> &order_pool_;
-  EngineStats &stats_;
+  std::vector<ShardLink> shards_;
+  std::vector<ConcurrentObjectPool<Order>::Cache> caches_; // one per shard
   std::size_t total_orders_;
+  std::size_t gateway_index_; // this gateway's k of n
+  std::size_t gateway_count_;
+  std::vector<uint16_t> instrument_of_id_; // local ID -> instrument (routing)
+  static_assert(config::INSTRUMENT_ID_SPACE <= 1 << 16,
+                "instrument_of_id_ stores instrument IDs as uint16_t");
+  static_assert(config::SIM_SESSION_COUNT >= config::MAX_GATEWAYS,
+                "every gateway needs at least one session of its own");
 
   // ── RNG state ──
   std::mt19937_64 rng_;
   std::uniform_real_distribution<double> dist_uniform_{0.0, 1.0};
   std::normal_distribution<double> dist_price_{0.0, 5000.0};
   std::uniform_int_distribution<uint32_t> dist_qty_{1, 999};
-  std::uniform_int_distribution<uint64_t> dist_instrument_{0, 99};
+  std::uniform_int_distribution<uint64_t> dist_instrument_{
+      0, config::SIM_INSTRUMENT_COUNT - 1};
 };
 
 // ═══════════════════════════════════════════════════════════════════════
-//  14. REPORT — Final statistics output
+//  29. REPORT — Final statistics output
 // ═══════════════════════════════════════════════════════════════════════
 
 namespace report {
@@ -1093,13 +4814,35 @@ namespace report {
   return std::string(buf);
 }
 
+/// Fold one shard's counters into a running total.
+inline void accumulate(EngineStats &total, const EngineStats &shard) {
+  total.orders_received += shard.orders_received.load();
+  total.orders_processed += shard.orders_processed.load();
+  total.total_fills += shard.total_fills.load();
+  total.ring_buffer_full_count += shard.ring_buffer_full_count.load();
+  total.pool_exhausted_count += shard.pool_exhausted_count.load();
+  total.unknown_instrument_count += shard.unknown_instrument_count.load();
+  total.add_reject_count += shard.add_reject_count.load();
+  total.execution_stall_count += shard.execution_stall_count.load();
+  total.market_data_drop_count += shard.market_data_drop_count.load();
+  total.order_feed_drop_count += shard.order_feed_drop_count.load();
+  total.orders_reclaimed += shard.orders_reclaimed.load();
+  total.orders_swept += shard.orders_swept.load();
+  total.orders_mass_cancelled += shard.orders_mass_cancelled.load();
+}
+
 inline void print_report(const EngineStats &stats, double elapsed_seconds,
-                         const MemoryArena &arena) {
+                         std::size_t arena_used, std::size_t arena_capacity) {
   auto received = stats.orders_received.load();
   auto processed = stats.orders_processed.load();
   auto fills = stats.total_fills.load();
   auto rb_full = stats.ring_buffer_full_count.load();
   auto pool_oom = stats.pool_exhausted_count.load();
+  auto unknown = stats.unknown_instrument_count.load();
+  auto add_rejects = stats.add_reject_count.load();
+  auto reclaimed = stats.orders_reclaimed.load();
+  auto swept = stats.orders_swept.load();
+  auto mass_cancelled = stats.orders_mass_cancelled.load();
 
   double throughput = (elapsed_seconds > 0)
                           ? static_cast<double>(processed) / elapsed_seconds
@@ -1157,9 +4900,34 @@ inline void print_report(const EngineStats &stats, double elapsed_seconds,
                 static_cast<unsigned long long>(pool_oom));
   std::cout << line;
 
-  double arena_used_mb = static_cast<double>(arena.used()) / (1024.0 * 1024.0);
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Unknown Instrument Rejects",
+                static_cast<unsigned long long>(unknown));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Price / Order ID Rejects",
+                static_cast<unsigned long long>(add_rejects));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Orders Reclaimed to Pool",
+                static_cast<unsigned long long>(reclaimed));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Dead Orders Swept While Idle",
+                static_cast<unsigned long long>(swept));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Orders Mass-Cancelled",
+                static_cast<unsigned long long>(mass_cancelled));
+  std::cout << line;
+
+  double arena_used_mb = static_cast<double>(arena_used) / (1024.0 * 1024.0);
   double arena_cap_mb =
-      static_cast<double>(arena.capacity()) / (1024.0 * 1024.0);
+      static_cast<double>(arena_capacity) / (1024.0 * 1024.0);
 
   std::snprintf(line, sizeof(line), "   %-30s %13.2f / %.0f MB\n",
                 "Arena Memory Used", arena_used_mb, arena_cap_mb);
@@ -1193,7 +4961,7 @@ inline void print_report(const EngineStats &stats, double elapsed_seconds,
                 zero_alloc_status);
   std::cout << line;
 
-  const char *lock_free_status = "[OK] PASSED (SPSC, no mutex)";
+  const char *lock_free_status = "[OK] PASSED (MPSC/SPSC, no mutex)";
   std::snprintf(line, sizeof(line), "   Lock-Free Communication:     %s\n",
                 lock_free_status);
   std::cout << line;
@@ -1202,87 +4970,311 @@ inline void print_report(const EngineStats &stats, double elapsed_seconds,
       << "================================================================\n\n";
 }
 
+inline void print_report(const EngineStats &stats, double elapsed_seconds,
+                         const MemoryArena &arena) {
+  print_report(stats, elapsed_seconds, arena.used(), arena.capacity());
+}
+
+/// Outbound fill stream, reconciled against the matchers' fill counters.
+inline void print_execution_stream(const EngineStats &stats,
+                                   const ExecutionConsumer &consumer) {
+  char line[128];
+  std::cout << "   [*] EXECUTION REPORTS\n"
+            << "   ─────────────────────────────────────────────────\n";
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n", "Reports Consumed",
+                static_cast<unsigned long long>(consumer.report_count()));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Executed Qty (units)",
+                static_cast<unsigned long long>(consumer.executed_qty()));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Matcher Back-Pressure Spins",
+                static_cast<unsigned long long>(
+                    stats.execution_stall_count.load()));
+  std::cout << line;
+
+  const char *status = (consumer.executed_qty() == stats.total_fills.load())
+                           ? "[OK] MATCHES TOTAL FILLS"
+                           : "[!!] MISMATCH WITH TOTAL FILLS";
+  std::snprintf(line, sizeof(line), "   Fill Stream Reconciled:      %s\n\n",
+                status);
+  std::cout << line;
+}
+
+/// Conflated depth cache: updates the matchers published against what the
+/// slow subscriber read and what was conflated away before it got there.
+inline void print_depth_cache(uint64_t published,
+                              const DepthCacheSubscriber &subscriber) {
+  std::cout << "   [*] CONFLATED DEPTH CACHE (SLOW SUBSCRIBER)\n"
+            << "   ─────────────────────────────────────────────────\n";
+
+  char line[160];
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n", "Updates Published",
+                static_cast<unsigned long long>(published));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n", "Subscriber Reads",
+                static_cast<unsigned long long>(subscriber.read_count()));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n", "Updates Seen",
+                static_cast<unsigned long long>(subscriber.update_count()));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n", "Conflated Away",
+                static_cast<unsigned long long>(subscriber.conflated_count()));
+  std::cout << line;
+
+  const char *status =
+      (subscriber.update_count() + subscriber.conflated_count() == published)
+          ? "[OK] SEEN + CONFLATED = PUBLISHED"
+          : "[!!] UPDATES UNACCOUNTED FOR";
+  std::snprintf(line, sizeof(line), "   Sequence Reconciled:         %s\n\n",
+                status);
+  std::cout << line;
+}
+
+/// L2 and L3 feeds: records sequenced by the matchers against what the
+/// consumer saw.
+inline void print_market_data_stream(const EngineStats &stats,
+                                     uint64_t sequenced,
+                                     uint64_t events_sequenced,
+                                     const MarketDataConsumer &consumer) {
+  char line[128];
+  std::cout << "   [*] L2 MARKET DATA\n"
+            << "   ─────────────────────────────────────────────────\n";
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Level Deltas Sequenced",
+                static_cast<unsigned long long>(sequenced));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Level Deltas Consumed",
+                static_cast<unsigned long long>(consumer.delta_count()));
+  std::cout << line;
+
+  uint64_t drops = stats.market_data_drop_count.load();
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Dropped on Full Ring", static_cast<unsigned long long>(drops));
+  std::cout << line;
+
+  const char *status =
+      (consumer.gap_count() == drops &&
+       consumer.delta_count() + drops == sequenced)
+          ? "[OK] GAPS MATCH DROPS"
+          : "[!!] UNEXPLAINED GAPS";
+  std::snprintf(line, sizeof(line), "   Sequence Reconciled:         %s\n\n",
+                status);
+  std::cout << line;
+
+  std::cout << "   [*] L3 ORDER FEED\n"
+            << "   ─────────────────────────────────────────────────\n";
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Order Events Sequenced",
+                static_cast<unsigned long long>(events_sequenced));
+  std::cout << line;
+
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Order Events Consumed",
+                static_cast<unsigned long long>(consumer.event_count()));
+  std::cout << line;
+
+  uint64_t event_drops = stats.order_feed_drop_count.load();
+  std::snprintf(line, sizeof(line), "   %-30s %20llu\n",
+                "Dropped on Full Ring",
+                static_cast<unsigned long long>(event_drops));
+  std::cout << line;
+
+  status = (consumer.event_gap_count() == event_drops &&
+            consumer.event_count() + event_drops == events_sequenced)
+               ? "[OK] GAPS MATCH DROPS"
+               : "[!!] UNEXPLAINED GAPS";
+  std::snprintf(line, sizeof(line), "   Sequence Reconciled:         %s\n\n",
+                status);
+  std::cout << line;
+}
+
+/// Per-shard load split (sharded mode only).
+inline void print_shard_breakdown(
+    const std::vector<std::unique_ptr<MatcherShard>> &shards) {
+  char line[128];
+  std::cout << "   [*] SHARDS\n"
+            << "   ─────────────────────────────────────────────────\n";
+  for (std::size_t i = 0; i < shards.size(); ++i) {
+    std::snprintf(line, sizeof(line), "   Shard %-2zu (%4zu instruments) %14llu\n",
+                  i, shards[i]->matcher.instruments().size(),
+                  static_cast<unsigned long long>(
+                      shards[i]->stats.orders_processed.load()));
+    std::cout << line;
+  }
+  std::cout << "\n";
+}
+
 } // namespace report
 
 // ═══════════════════════════════════════════════════════════════════════
-//  15. MAIN — Orchestration
+//  30. MAIN — Orchestration
 // ═══════════════════════════════════════════════════════════════════════
 
 #ifndef HYPER_CORE_NO_MAIN // Allow tests/benchmarks to exclude main()
 
-int main() {
+/// Usage: hyper_core_engine [shard_count [gateway_count]]
+/// shard_count matcher threads, shard i pinned to MATCHER_CORE_ID + i, fed
+/// by gateway_count gateway threads sharing GATEWAY_ORDER_COUNT orders.
+int main(int argc, char **argv) {
   using namespace std::chrono;
 
+  std::size_t shard_count = config::MATCHER_SHARD_COUNT;
+  if (argc > 1) {
+    shard_count = std::clamp<std::size_t>(std::strtoul(argv[1], nullptr, 10),
+                                          1, config::MAX_SHARDS);
+  }
+  std::size_t gateway_count = config::GATEWAY_THREAD_COUNT;
+  if (argc > 2) {
+    gateway_count = std::clamp<std::size_t>(
+        std::strtoul(argv[2], nullptr, 10), 1, config::MAX_GATEWAYS);
+  }
+
   std::cout
       << "\n"
       << "================================================================\n"
       << "  Hyper-Core HFT Matching Engine v1.0.0\n"
-      << "  C++20 | Lock-Free SPSC | Zero-Alloc | Cache-Optimized\n"
+      << "  C++20 | Lock-Free MPSC | Zero-Alloc | Cache-Optimized\n"
       << "================================================================\n"
       << "\n";
 
-  // ── Step 1: Pre-allocate all memory ──
-  std::cout << "[>>] Allocating Memory Arena ("
-            << config::ARENA_SIZE_BYTES / (1024 * 1024) << " MB)..."
-            << std::endl;
-
-  MemoryArena arena(config::ARENA_SIZE_BYTES);
-
-  std::cout << "[>>] Creating ObjectPool<Order> (" << config::MAX_ORDERS
-            << " slots, " << config::MAX_ORDERS * sizeof(Order) / (1024 * 1024)
-            << " MB)..." << std::endl;
-
-  ObjectPool<Order> order_pool(arena, config::MAX_ORDERS);
-
-  std::cout << "[>>] Creating SPSC Ring Buffer (capacity: "
-            << config::RING_BUFFER_CAPACITY << ")..." << std::endl;
-
-  LockFreeRingBuffer<OrderMessage> ring_buffer(arena);
-
-  // ── Step 2: Create shared stats ──
-  EngineStats stats{};
+  // ── Step 1: Pre-allocate all memory (one arena per shard) ──
+  const std::size_t pool_slots = config::MAX_ORDERS / shard_count;
+
+  std::cout << "[>>] Creating " << shard_count << " shard(s): ObjectPool<Order> ("
+            << pool_slots << " slots, "
+            << pool_slots * sizeof(Order) / (1024 * 1024)
+            << " MB) + MPSC Ring Buffer (capacity: "
+            << config::RING_BUFFER_CAPACITY << ") each..." << std::endl;
+
+  std::vector<std::unique_ptr<MatcherShard>> shards;
+  std::vector<ShardLink> links;
+  std::vector<LockFreeRingBuffer<ExecutionReport> *> execution_rings;
+  std::vector<LockFreeRingBuffer<LevelDelta> *> market_data_rings;
+  std::vector<LockFreeRingBuffer<OrderEvent> *> order_feed_rings;
+  std::vector<const DepthCacheCell *> depth_cells;
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    shards.push_back(std::make_unique<MatcherShard>(
+        pool_slots, config::MATCHER_CORE_ID + static_cast<int>(i)));
+    shards.back()->register_instruments(i, shard_count,
+                                        config::SIM_INSTRUMENT_COUNT);
+    links.push_back(ShardLink{&shards.back()->ring, &shards.back()->pool,
+                              &shards.back()->stats});
+    execution_rings.push_back(&shards.back()->executions);
+    market_data_rings.push_back(&shards.back()->market_data);
+    order_feed_rings.push_back(&shards.back()->order_feed);
+    const InstrumentDirectory &books = shards.back()->matcher.instruments();
+    for (uint64_t id = 0; id < config::SIM_INSTRUMENT_COUNT; ++id) {
+      if (const DepthCacheCell *cell = books.depth_cache(id))
+        depth_cells.push_back(cell);
+    }
+  }
 
-  std::cout << "[>>] Arena used after init: " << arena.used() / (1024 * 1024)
-            << " MB / " << arena.capacity() / (1024 * 1024) << " MB"
+  std::size_t arena_used = 0;
+  std::size_t arena_capacity = 0;
+  for (const auto &shard : shards) {
+    arena_used += shard->arena.used();
+    arena_capacity += shard->arena.capacity();
+  }
+  std::cout << "[>>] Arena used after init: " << arena_used / (1024 * 1024)
+            << " MB / " << arena_capacity / (1024 * 1024) << " MB"
             << std::endl;
 
-  // ── Step 3: Launch matcher thread (pinned) ──
-  std::cout << "[>>] Starting MatcherThread (pinned to core "
-            << config::MATCHER_CORE_ID << ")..." << std::endl;
+  // ── Step 2: Launch the outbound consumers, then the matchers (pinned) ──
+  ExecutionConsumer executions(execution_rings);
+  std::thread execution_thread(std::ref(executions));
+  MarketDataConsumer market_data(market_data_rings, order_feed_rings);
+  std::thread market_data_thread(std::ref(market_data));
+  DepthCacheSubscriber depth_subscriber(depth_cells);
+  std::thread depth_subscriber_thread(std::ref(depth_subscriber));
+
+  std::cout << "[>>] Starting " << shard_count
+            << " MatcherThread(s) (pinned to cores " << config::MATCHER_CORE_ID
+            << ".." << config::MATCHER_CORE_ID + shard_count - 1 << ")..."
+            << std::endl;
 
-  MatcherThread matcher(ring_buffer, order_pool, stats,
-                        config::MATCHER_CORE_ID);
-  std::thread matcher_thread(std::ref(matcher));
+  std::vector<std::thread> matcher_threads;
+  for (auto &shard : shards) {
+    matcher_threads.emplace_back(std::ref(shard->matcher));
+  }
 
-  // Brief pause to let matcher thread initialize and pin
+  // Brief pause to let matcher threads initialize and pin
   std::this_thread::sleep_for(milliseconds(50));
 
-  // ── Step 4: Launch gateway simulator ──
-  std::cout << "[>>] Starting GatewaySimulator (" << config::GATEWAY_ORDER_COUNT
-            << " orders)..." << std::endl;
+  // ── Step 3: Launch the gateway simulators ──
+  std::cout << "[>>] Starting " << gateway_count << " GatewaySimulator(s) ("
+            << config::GATEWAY_ORDER_COUNT << " orders)..." << std::endl;
 
   auto start_time = steady_clock::now();
 
-  GatewaySimulator gateway(ring_buffer, order_pool, stats,
-                           config::GATEWAY_ORDER_COUNT);
-  std::thread gateway_thread(std::ref(gateway));
+  std::vector<std::unique_ptr<GatewaySimulator>> gateways;
+  for (std::size_t i = 0; i < gateway_count; ++i) {
+    // Split the orders evenly; the first gateways take the remainder
+    std::size_t orders = config::GATEWAY_ORDER_COUNT / gateway_count +
+                         (i < config::GATEWAY_ORDER_COUNT % gateway_count);
+    gateways.push_back(
+        std::make_unique<GatewaySimulator>(links, orders, i, gateway_count));
+  }
+  std::vector<std::thread> gateway_threads;
+  for (auto &gateway : gateways)
+    gateway_threads.emplace_back(std::ref(*gateway));
 
-  // ── Step 5: Wait for gateway to finish ──
-  gateway_thread.join();
+  // ── Step 4: Wait for the gateways to finish ──
+  for (auto &t : gateway_threads)
+    t.join();
 
   // Brief drain period
   std::this_thread::sleep_for(milliseconds(100));
 
-  // ── Step 6: Signal stop and wait for matcher ──
-  stats.running.store(false, std::memory_order_release);
-  matcher_thread.join();
+  // ── Step 5: Signal stop and wait for matchers ──
+  for (auto &shard : shards) {
+    shard->stats.running.store(false, std::memory_order_release);
+  }
+  for (auto &t : matcher_threads) {
+    t.join();
+  }
+  executions.stop(); // Matchers are gone: drain what they published
+  execution_thread.join();
+  market_data.stop();
+  market_data_thread.join();
+  depth_subscriber.stop();
+  depth_subscriber_thread.join();
 
   auto end_time = steady_clock::now();
   double elapsed =
       duration_cast<microseconds>(end_time - start_time).count() / 1e6;
 
-  // ── Step 7: Print report ──
-  report::print_report(stats, elapsed, arena);
+  // ── Step 6: Print report ──
+  EngineStats total{};
+  uint64_t deltas_sequenced = 0;
+  uint64_t events_sequenced = 0;
+  for (const auto &shard : shards) {
+    report::accumulate(total, shard->stats);
+    deltas_sequenced += shard->md_sink.sequence();
+    events_sequenced += shard->l3_sink.sequence();
+  }
+  report::print_report(total, elapsed, arena_used, arena_capacity);
+  report::print_execution_stream(total, executions);
+  report::print_market_data_stream(total, deltas_sequenced, events_sequenced,
+                                   market_data);
+  uint64_t depth_updates = 0;
+  for (const DepthCacheCell *cell : depth_cells)
+    depth_updates += cell->read().sequence;
+  report::print_depth_cache(depth_updates, depth_subscriber);
+  if (shard_count > 1) {
+    report::print_shard_breakdown(shards);
+  }
 
   return 0;
 }
@@ -8,11 +8,17 @@
  *   Tests verify correctness of every core component:
  *     - MemoryArena (bump allocation, alignment, reset)
  *     - ObjectPool  (acquire, release, recycling)
+ *     - ConcurrentObjectPool (magazine exchange, cross-thread handoff)
  *     - LockFreeRingBuffer (push, pop, empty/full)
  *     - Order struct (layout, trivial copyability)
  *     - IntrusiveOrderList (push_back, match, compact)
  *     - PriceLevel (add, match, cancel, compact)
- *     - OrderBook (limit orders, market orders, cancellations, matching)
+ *     - OccupancyBitmap (next/prev set slot across all three levels)
+ *     - OrderBook (limit orders, market orders, cancellations, matching,
+ *       tick size, sliding price window)
+ *     - InstrumentDirectory (slot lookup, per-instrument isolation)
+ *     - Sharding (instrument partition, gateway routing)
+ *     - Execution reports (one per fill, maker/taker, sink wiring)
  *
  *   Build:
  *     g++ -std=c++20 -O2 -Wall -Wextra -pthread tests/test_hyper_core.cpp -o
@@ -26,6 +32,7 @@
 #include "../hyper_core_engine.cpp"
 
 #include <iostream>
+#include <random>
 #include <sstream>
 #include <string>
 
@@ -184,8 +191,122 @@ TEST_CASE(Pool_exhaustion_returns_null) {
   REQUIRE(o3 == nullptr);
 }
 
+TEST_CASE(ConcurrentPool_returns_objects_in_whole_magazines) {
+  constexpr std::size_t N = 200;
+  constexpr std::size_t MAG = config::POOL_MAGAZINE_SIZE;
+  MemoryArena arena(1024 * 1024);
+  ConcurrentObjectPool<Order> pool(arena, N);
+  REQUIRE_EQ(pool.available(), N);
+
+  std::vector<Order *> held;
+  {
+    ConcurrentObjectPool<Order>::Cache producer(pool);
+    ConcurrentObjectPool<Order>::Cache consumer(pool);
+    for (std::size_t i = 0; i < N; ++i) {
+      held.push_back(producer.acquire());
+      REQUIRE(held.back() != nullptr);
+    }
+    REQUIRE(producer.acquire() == nullptr); // exhausted
+    REQUIRE_EQ(pool.in_use(), N);
+
+    // Released objects become visible to the producer one full magazine
+    // at a time; the partial one stays parked in the consumer's cache
+    for (Order *o : held)
+      consumer.release(o);
+    REQUIRE_EQ(pool.available(), (N / MAG) * MAG);
+    for (std::size_t i = 0; i < (N / MAG) * MAG; ++i)
+      REQUIRE(producer.acquire() != nullptr);
+    REQUIRE(producer.acquire() == nullptr);
+  }
+  // Destroyed caches hand their magazines back
+  REQUIRE_EQ(pool.available(), N % MAG);
+}
+
+TEST_CASE(ConcurrentPool_cross_thread_handoff_never_duplicates) {
+  constexpr std::size_t SLOTS = 1'000;
+  constexpr uint64_t N = 200'000;
+  MemoryArena arena(8 * 1024 * 1024);
+  ConcurrentObjectPool<Order> pool(arena, SLOTS);
+  LockFreeRingBuffer<Order *> handoff(arena);
+
+  std::atomic<bool> in_order{true};
+  {
+    ConcurrentObjectPool<Order>::Cache producer(pool);
+    ConcurrentObjectPool<Order>::Cache consumer(pool);
+
+    std::thread matcher([&] {
+      Order *o = nullptr;
+      for (uint64_t expected = 1; expected <= N;) {
+        if (!handoff.pop(o))
+          continue;
+        // A slot handed out twice would have been re-stamped in flight
+        if (o->id != expected)
+          in_order.store(false, std::memory_order_relaxed);
+        consumer.release(o);
+        ++expected;
+      }
+    });
+
+    for (uint64_t id = 1; id <= N; ++id) {
+      Order *o;
+      while (!(o = producer.acquire()))
+        std::this_thread::yield();
+      o->id = id;
+      while (!handoff.push(o))
+        std::this_thread::yield();
+    }
+    matcher.join();
+  }
+
+  REQUIRE(in_order.load());
+  REQUIRE_EQ(pool.available(), SLOTS);
+}
+
+TEST_CASE(ConcurrentPool_short_lived_caches_do_not_use_up_magazines) {
+  constexpr std::size_t MAG = config::POOL_MAGAZINE_SIZE;
+  constexpr std::size_t N = 20 * MAG;
+  constexpr std::size_t SESSIONS = 4 * config::POOL_MAX_CACHES;
+  MemoryArena arena(4 * 1024 * 1024);
+  ConcurrentObjectPool<Order> pool(arena, N);
+
+  std::vector<Order *> held;
+  {
+    ConcurrentObjectPool<Order>::Cache matcher(pool);
+    while (Order *o = matcher.acquire())
+      held.push_back(o);
+    REQUIRE_EQ(held.size(), N);
+
+    // Thread-per-session: each cache frees a few orders and goes away with
+    // a partly filled magazine, many more of them than POOL_MAX_CACHES
+    std::size_t next = 0;
+    for (std::size_t s = 0; s < SESSIONS; ++s) {
+      ConcurrentObjectPool<Order>::Cache session(pool);
+      for (int i = 0; i < 3; ++i)
+        session.release(held[next++]);
+    }
+    REQUIRE_EQ(pool.available(), next);
+
+    // A long-lived cache still finds empty magazines to swap in
+    for (; next < N; ++next)
+      matcher.release(held[next]);
+  }
+  REQUIRE_EQ(pool.available(), N);
+
+  // Every slot comes back exactly once
+  std::vector<bool> seen(N, false);
+  ConcurrentObjectPool<Order>::Cache gateway(pool);
+  for (std::size_t i = 0; i < N; ++i) {
+    Order *o = gateway.acquire();
+    REQUIRE(o != nullptr);
+    auto slot = static_cast<std::size_t>(o - pool.data());
+    REQUIRE(!seen[slot]);
+    seen[slot] = true;
+  }
+  REQUIRE(gateway.acquire() == nullptr);
+}
+
 // ═══════════════════════════════════════════════════════════════════════
-//  4. LockFreeRingBuffer Tests
+//  4. LockFreeRingBuffer / MpscRingBuffer Tests
 // ═══════════════════════════════════════════════════════════════════════
 
 TEST_CASE(RingBuffer_starts_empty) {
@@ -201,7 +322,7 @@ TEST_CASE(RingBuffer_push_and_pop) {
 
   OrderMessage msg{};
   msg.type = OrderType::LIMIT;
-  msg.cancel_id = 42;
+  msg.target_id = 42;
 
   REQUIRE(rb.push(msg));
   REQUIRE(!rb.empty());
@@ -209,7 +330,7 @@ TEST_CASE(RingBuffer_push_and_pop) {
   OrderMessage out{};
   REQUIRE(rb.pop(out));
   REQUIRE_EQ(static_cast<int>(out.type), static_cast<int>(OrderType::LIMIT));
-  REQUIRE_EQ(out.cancel_id, static_cast<uint64_t>(42));
+  REQUIRE_EQ(out.target_id, static_cast<uint64_t>(42));
   REQUIRE(rb.empty());
 }
 
@@ -220,6 +341,215 @@ TEST_CASE(RingBuffer_pop_on_empty_fails) {
   REQUIRE(!rb.pop(out));
 }
 
+TEST_CASE(RingBuffer_bulk_ops_are_partial_at_the_bounds_and_wrap) {
+  MemoryArena arena(config::RING_BUFFER_CAPACITY * sizeof(uint64_t) + 4096);
+  LockFreeRingBuffer<uint64_t> rb(arena);
+  constexpr std::size_t USABLE = config::RING_BUFFER_CAPACITY - 1;
+
+  // Park the indices just short of the end of the storage
+  uint64_t next_in = 0;
+  uint64_t next_out = 0;
+  uint64_t v = 0;
+  for (std::size_t i = 0; i < USABLE - 3; ++i) {
+    REQUIRE(rb.push(next_in++));
+    REQUIRE(rb.pop(v));
+    REQUIRE_EQ(v, next_out++);
+  }
+
+  // A batch bigger than the free space stops at the full mark
+  std::vector<uint64_t> in(USABLE + 10);
+  for (auto &x : in)
+    x = next_in++;
+  REQUIRE_EQ(rb.push_bulk(in.data(), in.size()), USABLE);
+  REQUIRE(!rb.push(0));
+  REQUIRE_EQ(rb.push_bulk(in.data(), 1), static_cast<std::size_t>(0));
+
+  // Pops come back in order across the wrap, then run dry
+  std::vector<uint64_t> out(100);
+  std::size_t popped = 0;
+  while (std::size_t n = rb.pop_bulk(out.data(), out.size())) {
+    for (std::size_t i = 0; i < n; ++i)
+      REQUIRE_EQ(out[i], next_out++);
+    popped += n;
+  }
+  REQUIRE_EQ(popped, USABLE);
+  REQUIRE(rb.empty());
+  REQUIRE(!rb.pop(v));
+}
+
+TEST_CASE(RingBuffer_bulk_stream_between_threads_keeps_order) {
+  constexpr uint64_t ITEMS = 2'000'000;
+  MemoryArena arena(config::RING_BUFFER_CAPACITY * sizeof(uint64_t) + 4096);
+  LockFreeRingBuffer<uint64_t> rb(arena);
+
+  std::thread producer([&] {
+    std::array<uint64_t, 37> batch{}; // odd size: batches straddle the wrap
+    for (uint64_t next = 0; next < ITEMS;) {
+      std::size_t n = std::min<uint64_t>(batch.size(), ITEMS - next);
+      for (std::size_t i = 0; i < n; ++i)
+        batch[i] = next + i;
+      std::size_t pushed = (next % 3 == 0) ? rb.push(batch[0])
+                                           : rb.push_bulk(batch.data(), n);
+      if (pushed == 0)
+        std::this_thread::yield();
+      next += pushed;
+    }
+  });
+
+  std::array<uint64_t, 64> out{};
+  uint64_t expected = 0;
+  bool in_order = true;
+  while (expected < ITEMS) {
+    std::size_t n = (expected % 5 == 0) ? rb.pop(out[0])
+                                        : rb.pop_bulk(out.data(), out.size());
+    if (n == 0)
+      std::this_thread::yield();
+    for (std::size_t i = 0; i < n; ++i)
+      in_order &= out[i] == expected++;
+  }
+  producer.join();
+  REQUIRE(in_order);
+  REQUIRE(rb.empty());
+}
+
+TEST_CASE(RingBuffer_claim_and_peek_work_in_the_slot) {
+  struct Wide { // well past OrderMessage's 32 bytes
+    uint64_t words[32];
+  };
+  MemoryArena arena(config::RING_BUFFER_CAPACITY * sizeof(Wide) + 4096);
+  LockFreeRingBuffer<Wide> rb(arena);
+
+  // Claimed but not committed: invisible, and claimed again as the same slot
+  Wide *slot = rb.try_claim();
+  REQUIRE(slot != nullptr);
+  REQUIRE(rb.try_claim() == slot);
+  REQUIRE(rb.peek() == nullptr);
+  for (uint64_t i = 0; i < 32; ++i)
+    slot->words[i] = i * i;
+  rb.commit();
+
+  // The consumer reads the very storage the producer wrote
+  const Wide *seen = rb.peek();
+  REQUIRE(seen == slot);
+  REQUIRE_EQ(seen->words[31], uint64_t{961});
+  REQUIRE(rb.peek() == seen); // peek does not consume
+  rb.release();
+  REQUIRE(rb.empty());
+  REQUIRE(rb.peek() == nullptr);
+
+  // Claims stop at the same full mark as push()
+  for (std::size_t i = 0; i < config::RING_BUFFER_CAPACITY - 1; ++i) {
+    Wide *next = rb.try_claim();
+    REQUIRE(next != nullptr);
+    next->words[0] = i;
+    rb.commit();
+  }
+  REQUIRE(rb.try_claim() == nullptr);
+  REQUIRE_EQ(rb.peek()->words[0], uint64_t{0});
+}
+
+TEST_CASE(MpscRing_commits_in_any_order_come_out_in_claim_order) {
+  MemoryArena arena(MpscRingBuffer<uint64_t>::arena_bytes());
+  MpscRingBuffer<uint64_t> rb(arena);
+
+  uint64_t *first = rb.try_claim();
+  uint64_t *second = rb.try_claim();
+  REQUIRE(first != nullptr && second != nullptr && first != second);
+  *first = 1;
+  *second = 2;
+
+  // The later claim is committed first: it waits behind the earlier one
+  rb.commit(second);
+  REQUIRE(rb.peek() == nullptr);
+  rb.commit(first);
+
+  const uint64_t *seen = rb.peek();
+  REQUIRE(seen == first);
+  REQUIRE_EQ(*seen, uint64_t{1});
+  rb.release();
+  REQUIRE(rb.peek() == second);
+  rb.release();
+  REQUIRE(rb.empty());
+
+  // Released slots go back to the producers' next round
+  for (std::size_t i = 0; i < config::RING_BUFFER_CAPACITY; ++i) {
+    uint64_t *slot = rb.try_claim();
+    REQUIRE(slot != nullptr);
+    *slot = i;
+    rb.commit(slot);
+  }
+  REQUIRE(rb.try_claim() == nullptr);
+  REQUIRE_EQ(*rb.peek(), uint64_t{0});
+}
+
+TEST_CASE(MpscRing_fills_every_slot_and_wraps) {
+  MemoryArena arena(MpscRingBuffer<uint64_t>::arena_bytes());
+  MpscRingBuffer<uint64_t> rb(arena);
+  constexpr std::size_t CAPACITY = config::RING_BUFFER_CAPACITY;
+  REQUIRE(rb.empty());
+
+  // Three laps around the storage: no slot is held back
+  uint64_t next_in = 0;
+  uint64_t next_out = 0;
+  uint64_t v = 0;
+  std::vector<uint64_t> out(CAPACITY / 3 + 1);
+  for (int lap = 0; lap < 3; ++lap) {
+    for (std::size_t i = 0; i < CAPACITY; ++i)
+      REQUIRE(rb.push(next_in++));
+    REQUIRE_EQ(rb.size(), CAPACITY);
+    REQUIRE(!rb.push(0));
+
+    REQUIRE(rb.pop(v));
+    REQUIRE_EQ(v, next_out++);
+    while (std::size_t n = rb.pop_bulk(out.data(), out.size())) {
+      for (std::size_t i = 0; i < n; ++i)
+        REQUIRE_EQ(out[i], next_out++);
+    }
+    REQUIRE_EQ(next_out, next_in);
+    REQUIRE(rb.empty());
+    REQUIRE(!rb.pop(v));
+  }
+}
+
+TEST_CASE(MpscRing_producers_each_keep_their_own_order) {
+  constexpr uint64_t PRODUCERS = 4;
+  constexpr uint64_t ITEMS = 500'000; // per producer
+  MemoryArena arena(MpscRingBuffer<uint64_t>::arena_bytes());
+  MpscRingBuffer<uint64_t> rb(arena);
+
+  std::vector<std::thread> producers;
+  for (uint64_t p = 0; p < PRODUCERS; ++p) {
+    producers.emplace_back([&rb, p] {
+      for (uint64_t i = 0; i < ITEMS; ++i) {
+        while (!rb.push(p << 32 | i))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  // Items from different producers interleave; each producer's stay in
+  // the order it pushed them
+  std::array<uint64_t, PRODUCERS> next{};
+  std::array<uint64_t, 64> out{};
+  uint64_t total = 0;
+  bool in_order = true;
+  while (total < PRODUCERS * ITEMS) {
+    std::size_t n = (total % 3 == 0) ? rb.pop(out[0])
+                                     : rb.pop_bulk(out.data(), out.size());
+    if (n == 0)
+      std::this_thread::yield();
+    for (std::size_t i = 0; i < n; ++i)
+      in_order &= (out[i] & 0xFFFFFFFF) == next[out[i] >> 32]++;
+    total += n;
+  }
+  for (auto &t : producers)
+    t.join();
+  REQUIRE(in_order);
+  for (uint64_t count : next)
+    REQUIRE_EQ(count, ITEMS);
+  REQUIRE(rb.empty());
+}
+
 // ═══════════════════════════════════════════════════════════════════════
 //  5. IntrusiveOrderList Tests
 // ═══════════════════════════════════════════════════════════════════════
@@ -316,6 +646,68 @@ TEST_CASE(IntrusiveList_compact_removes_dead_nodes) {
   REQUIRE(list.head() == o2);
 }
 
+TEST_CASE(IntrusiveList_unlink_any_position) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+
+  IntrusiveOrderList list;
+  Order *o[5];
+  for (int i = 0; i < 5; ++i) {
+    o[i] = pool.acquire();
+    o[i]->id = static_cast<uint64_t>(i);
+    list.push_back(o[i]);
+  }
+
+  list.unlink(o[2]); // middle
+  list.unlink(o[0]); // head
+  list.unlink(o[4]); // tail
+  REQUIRE_EQ(list.size(), static_cast<std::size_t>(2));
+  REQUIRE(list.head() == o[1]);
+  REQUIRE(o[1]->prev == nullptr);
+  REQUIRE(o[1]->next == o[3]);
+  REQUIRE(o[3]->prev == o[1]);
+  REQUIRE(o[3]->next == nullptr);
+  REQUIRE(o[2]->next == nullptr && o[2]->prev == nullptr);
+
+  list.unlink(o[1]);
+  list.unlink(o[3]); // sole node
+  REQUIRE(list.empty());
+  list.push_back(o[4]); // tail was reset too
+  REQUIRE(list.head() == o[4]);
+  REQUIRE(o[4]->prev == nullptr);
+}
+
+TEST_CASE(IntrusiveList_dead_nodes_move_to_graveyard) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+
+  IntrusiveOrderList list;
+  IntrusiveOrderList graveyard;
+  Order *o[4];
+  for (int i = 0; i < 4; ++i) {
+    o[i] = pool.acquire();
+    o[i]->remaining_qty = (i == 0 || i == 2) ? 0 : 10; // 0 and 2 are dead
+    o[i]->active = (i == 0 || i == 2) ? 0 : 1;
+    list.push_back(o[i]);
+  }
+
+  // front_live unlinks only the dead prefix
+  REQUIRE(list.front_live(&graveyard) == o[1]);
+  REQUIRE_EQ(graveyard.size(), static_cast<std::size_t>(1));
+  list.compact(&graveyard);
+  REQUIRE_EQ(graveyard.size(), static_cast<std::size_t>(2));
+  REQUIRE_EQ(list.size(), static_cast<std::size_t>(2));
+
+  // drain_into splices the rest in O(1), keeping order
+  list.drain_into(&graveyard);
+  REQUIRE(list.empty());
+  REQUIRE_EQ(graveyard.size(), static_cast<std::size_t>(4));
+  Order *expected[4] = {o[0], o[2], o[1], o[3]};
+  for (Order *e : expected)
+    REQUIRE(graveyard.pop_front() == e);
+  REQUIRE(graveyard.empty());
+}
+
 TEST_CASE(IntrusiveList_unbounded_capacity_no_malloc) {
   // This is the KEY test: push 5000 orders (way beyond the old 1024 reserve)
   // with ZERO memory allocation — proving the intrusive list advantage.
@@ -371,8 +763,111 @@ TEST_CASE(PriceLevel_reduce_qty_for_cancel) {
   REQUIRE_EQ(level.total_qty(), static_cast<uint32_t>(0));
 }
 
+TEST_CASE(PriceLevel_iceberg_shows_one_slice_and_refills_at_the_tail) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  PriceLevel level(1000000);
+
+  Order *iceberg = pool.acquire();
+  iceberg->remaining_qty = 10; // shown
+  iceberg->hidden_qty = 25;
+  iceberg->peak_qty = 10;
+  iceberg->active = 1;
+  Order *plain = pool.acquire();
+  plain->remaining_qty = 5;
+  plain->active = 1;
+  level.add_order(iceberg);
+  level.add_order(plain);
+  REQUIRE_EQ(level.total_qty(), static_cast<uint32_t>(15)); // reserve unseen
+
+  // The slice fills: the next one shows behind the plain order
+  REQUIRE_EQ(level.match(10), static_cast<uint32_t>(10));
+  REQUIRE_EQ(level.front(), plain);
+  REQUIRE_EQ(iceberg->remaining_qty, static_cast<uint32_t>(10));
+  REQUIRE_EQ(iceberg->hidden_qty, static_cast<uint32_t>(15));
+  REQUIRE_EQ(level.total_qty(), static_cast<uint32_t>(15));
+  REQUIRE_EQ(level.order_count(), static_cast<std::size_t>(2));
+
+  // Everything left trades through the same Order, last slice 5
+  REQUIRE_EQ(level.match(100), static_cast<uint32_t>(30));
+  REQUIRE_EQ(iceberg->active, static_cast<uint8_t>(0));
+  REQUIRE_EQ(iceberg->hidden_qty, static_cast<uint32_t>(0));
+  REQUIRE_EQ(level.total_qty(), static_cast<uint32_t>(0));
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  7. OccupancyBitmap Tests
+// ═══════════════════════════════════════════════════════════════════════
+
+TEST_CASE(Bitmap_find_next_and_prev_across_words) {
+  OccupancyBitmap<10'000> bm;
+  constexpr std::size_t NONE = OccupancyBitmap<10'000>::NONE;
+  REQUIRE(!bm.any());
+  REQUIRE_EQ(bm.find_next(0), NONE);
+  REQUIRE_EQ(bm.find_prev(9'999), NONE);
+
+  for (std::size_t i : {3, 700, 5'000, 9'999})
+    bm.set(i);
+
+  REQUIRE_EQ(bm.find_next(0), static_cast<std::size_t>(3));
+  REQUIRE_EQ(bm.find_next(4), static_cast<std::size_t>(700));
+  REQUIRE_EQ(bm.find_next(701), static_cast<std::size_t>(5'000));
+  REQUIRE_EQ(bm.find_next(5'001), static_cast<std::size_t>(9'999));
+  REQUIRE_EQ(bm.find_next(10'000), NONE);
+  REQUIRE_EQ(bm.find_prev(20'000), static_cast<std::size_t>(9'999));
+  REQUIRE_EQ(bm.find_prev(9'998), static_cast<std::size_t>(5'000));
+  REQUIRE_EQ(bm.find_prev(699), static_cast<std::size_t>(3));
+  REQUIRE_EQ(bm.find_prev(2), NONE);
+}
+
+TEST_CASE(Bitmap_clear_propagates_to_summary) {
+  OccupancyBitmap<10'000> bm;
+  bm.set(4'101);
+  bm.set(4'102);
+  bm.clear(4'101);
+  REQUIRE(bm.any());
+  REQUIRE(bm.test(4'102));
+  bm.clear(4'102);
+  REQUIRE(!bm.any());
+  REQUIRE_EQ(bm.find_next(0), OccupancyBitmap<10'000>::NONE);
+}
+
+TEST_CASE(Bitmap_matches_linear_scan) {
+  constexpr std::size_t N = 5'000;
+  OccupancyBitmap<N> bm;
+  std::vector<bool> ref(N, false);
+  std::mt19937_64 rng(7);
+
+  for (int step = 0; step < 20'000; ++step) {
+    std::size_t i = rng() % N;
+    if (rng() & 1) {
+      bm.set(i);
+      ref[i] = true;
+    } else {
+      bm.clear(i);
+      ref[i] = false;
+    }
+
+    std::size_t q = rng() % N;
+    std::size_t next = N;
+    for (std::size_t k = q; k < N; ++k)
+      if (ref[k]) {
+        next = k;
+        break;
+      }
+    std::size_t prev = N;
+    for (std::size_t k = q + 1; k-- > 0;)
+      if (ref[k]) {
+        prev = k;
+        break;
+      }
+    REQUIRE_EQ(bm.find_next(q), next);
+    REQUIRE_EQ(bm.find_prev(q), prev);
+  }
+}
+
 // ═══════════════════════════════════════════════════════════════════════
-//  7. OrderBook Tests
+//  8. OrderBook Tests
 // ═══════════════════════════════════════════════════════════════════════
 
 TEST_CASE(OrderBook_add_limit_order) {
@@ -417,6 +912,60 @@ TEST_CASE(OrderBook_cancel_nonexistent_returns_false) {
   REQUIRE(!book.cancel_order(999999));
 }
 
+TEST_CASE(OrderBook_ids_2pow20_apart_both_cancellable) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 10);
+  OrderBook book;
+
+  Order *first = pool.acquire();
+  first->id = 7;
+  first->price = 1'000'000;
+  first->remaining_qty = 10;
+  first->side = Side::BID;
+  REQUIRE(book.add_order(first));
+
+  Order *second = pool.acquire();
+  *second = *first;
+  second->id = 7 + (1ULL << 20); // same slot in a 1M direct-mapped table
+  REQUIRE(book.add_order(second));
+
+  Order *duplicate = pool.acquire();
+  *duplicate = *first; // ID already live: refused, book unchanged
+  REQUIRE(!book.add_order(duplicate));
+
+  REQUIRE(book.cancel_order(7));
+  REQUIRE(book.cancel_order(7 + (1ULL << 20)));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(0));
+}
+
+TEST_CASE(OrderIdMap_churn_respects_probe_bound) {
+  constexpr std::size_t LIVE = 4'000;
+  std::vector<Order> orders(LIVE);
+  OrderIdMap ids(LIVE);
+
+  std::mt19937_64 rng(11);
+  for (auto &order : orders) {
+    order.id = rng();
+    REQUIRE(ids.insert(&order));
+  }
+
+  // Replace a random order 200K times; no tombstones, no drift
+  for (int step = 0; step < 200'000; ++step) {
+    Order &order = orders[rng() % LIVE];
+    REQUIRE(ids.find(order.id) == &order);
+    ids.erase(order.id);
+    REQUIRE(ids.find(order.id) == nullptr);
+    order.id = rng();
+    REQUIRE(ids.insert(&order));
+  }
+
+  REQUIRE_EQ(ids.size(), LIVE);
+  REQUIRE(ids.size() * 4 <= ids.slot_count() * 3);
+  REQUIRE(ids.max_displacement() <= config::ORDER_ID_MAX_PROBE);
+  for (auto &order : orders)
+    REQUIRE(ids.find(order.id) == &order);
+}
+
 TEST_CASE(OrderBook_match_crossing_orders) {
   MemoryArena arena(64 * 1024 * 1024);
   ObjectPool<Order> pool(arena, 1000);
@@ -476,6 +1025,1504 @@ TEST_CASE(OrderBook_market_order_fills) {
   REQUIRE_EQ(ask->remaining_qty, static_cast<uint32_t>(50));
 }
 
+TEST_CASE(OrderBook_sparse_book_tracks_best_levels) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  OrderBook book;
+
+  auto make = [&](uint64_t id, int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = price;
+    o->remaining_qty = qty;
+    o->side = side;
+    return o;
+  };
+
+  // Bids and asks thousands of levels apart
+  book.add_order(make(1, 981'000, 10, Side::BID));
+  book.add_order(make(2, 1'015'000, 10, Side::BID));
+  book.add_order(make(3, 1'018'000, 10, Side::ASK));
+  book.add_order(make(4, 982'000, 10, Side::ASK)); // crosses the top bid
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'015'000));
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(982'000));
+
+  REQUIRE_EQ(book.match(), static_cast<uint64_t>(10));
+  // Top bid consumed; the next bid sits 3400 empty levels below
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(981'000));
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(1'018'000));
+
+  REQUIRE(book.cancel_order(1));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(0)); // side empty
+}
+
+TEST_CASE(OrderBook_rejects_off_tick_prices) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 10);
+  OrderBook book(nullptr, 25);
+
+  Order *off = pool.acquire();
+  off->id = 1;
+  off->price = 1'000'010;
+  off->remaining_qty = 10;
+  off->side = Side::BID;
+  REQUIRE(!book.add_order(off));
+  REQUIRE(!book.cancel_order(1)); // never entered the book
+
+  Order *on = pool.acquire();
+  on->id = 2;
+  on->price = 1'000'025;
+  on->remaining_qty = 10;
+  on->side = Side::BID;
+  REQUIRE(book.add_order(on));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'000'025));
+}
+
+TEST_CASE(OrderBook_window_recenters_and_keeps_resting_levels) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  OrderBook book; // tick 10, window centered on MID_PRICE
+
+  auto make = [&](uint64_t id, int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = price;
+    o->remaining_qty = qty;
+    o->side = side;
+    return o;
+  };
+
+  REQUIRE(book.add_order(make(1, 1'005'000, 10, Side::BID)));
+  REQUIRE(book.add_order(make(2, 1'010'000, 10, Side::ASK)));
+
+  // Ask well above the initial window: the window slides up and wraps
+  REQUIRE(book.add_order(make(3, 1'040'000, 10, Side::ASK)));
+  REQUIRE_EQ(book.recenter_count(), static_cast<uint64_t>(1));
+  REQUIRE(book.window_low_price() <= 1'005'000);
+  REQUIRE(book.window_high_price() >= 1'040'000);
+
+  // Best prices survive the slot wrap
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'005'000));
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(1'010'000));
+  REQUIRE(book.cancel_order(2));
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(1'040'000));
+
+  // A bid that sweeps the wrapped level matches at the right price
+  REQUIRE(book.add_order(make(4, 1'040'000, 4, Side::BID)));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'040'000));
+  REQUIRE_EQ(book.match(), static_cast<uint64_t>(4));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'005'000));
+
+  // Spanning more than the window would evict a resting level: refused
+  int64_t too_far = 1'005'000 + static_cast<int64_t>(
+                                    config::PRICE_WINDOW_LEVELS) * 10;
+  REQUIRE(!book.add_order(make(5, too_far, 10, Side::ASK)));
+  REQUIRE_EQ(book.recenter_count(), static_cast<uint64_t>(1));
+
+  // Once the low bid is gone, the same price is accepted
+  REQUIRE(book.cancel_order(1));
+  REQUIRE(book.add_order(make(6, too_far, 10, Side::ASK)));
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(1'040'000));
+}
+
+TEST_CASE(OrderBook_limit_crosses_on_entry_and_rests_residual) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 16);
+  InstrumentDirectory dir;
+  dir.add_instrument(0);
+  OrderBook &book = *dir.find(0);
+
+  auto make = [&](uint64_t id, int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = price;
+    o->remaining_qty = qty;
+    o->side = side;
+    return o;
+  };
+
+  REQUIRE_EQ(book.submit_limit(make(1, 1'000'000, 5, Side::ASK)),
+             static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_limit(make(2, 1'000'100, 5, Side::ASK)),
+             static_cast<uint64_t>(0));
+
+  // Sweeps both asks at their own prices, rests 2 at its limit
+  Order *bid = make(3, 1'000'100, 12, Side::BID);
+  REQUIRE_EQ(book.submit_limit(bid), static_cast<uint64_t>(10));
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(0));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'000'100));
+  REQUIRE_EQ(bid->remaining_qty, static_cast<uint32_t>(2));
+  REQUIRE_EQ(book.match_count(), static_cast<uint64_t>(2));
+
+  // Fully filled on entry: never rests, goes straight to the graveyard
+  Order *sell = make(4, 990'000, 2, Side::ASK);
+  REQUIRE_EQ(book.submit_limit(sell), static_cast<uint64_t>(2));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(0));
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(0));
+  REQUIRE_EQ(dir.pending_reclaim(), static_cast<std::size_t>(4));
+  REQUIRE_EQ(dir.reclaim(pool, 8), static_cast<std::size_t>(4));
+  REQUIRE(!dir.cancel_order(4));
+
+  Order *off_tick = make(5, 1'000'005, 1, Side::BID);
+  REQUIRE_EQ(book.submit_limit(off_tick), OrderBook::REJECTED);
+  REQUIRE_EQ(off_tick->active, static_cast<uint8_t>(0));
+}
+
+TEST_CASE(OrderBook_replace_size_down_keeps_priority_size_up_loses_it) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 16);
+  OrderBook book;
+
+  auto make = [&](uint64_t id, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = 1'000'000;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    return o;
+  };
+  Order *first = make(1, 10, Side::BID);
+  Order *second = make(2, 10, Side::BID);
+  Order *third = make(3, 10, Side::BID);
+  book.add_order(first);
+  book.add_order(second);
+  book.add_order(third);
+
+  // Less size: still first in line
+  REQUIRE_EQ(book.replace_order(1, 1'000'000, 4), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.match_market(make(10, 4, Side::ASK)),
+             static_cast<uint64_t>(4));
+  REQUIRE_EQ(first->active, static_cast<uint8_t>(0));
+  REQUIRE_EQ(second->remaining_qty, static_cast<uint32_t>(10));
+
+  // More size: goes behind the order that was behind it
+  REQUIRE_EQ(book.replace_order(2, 1'000'000, 20), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.match_market(make(11, 10, Side::ASK)),
+             static_cast<uint64_t>(10));
+  REQUIRE_EQ(third->active, static_cast<uint8_t>(0));
+  REQUIRE_EQ(second->remaining_qty, static_cast<uint32_t>(20));
+  REQUIRE_EQ(second->quantity, static_cast<uint32_t>(20));
+  REQUIRE_EQ(book.replace_count(), static_cast<uint64_t>(2));
+}
+
+TEST_CASE(OrderBook_replace_moves_price_without_the_pool) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 16);
+  OrderBook book;
+
+  auto make = [&](uint64_t id, int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = price;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    REQUIRE(book.add_order(o));
+    return o;
+  };
+  Order *ask = make(1, 1'000'100, 10, Side::ASK);
+  Order *bid = make(2, 990'000, 5, Side::BID);
+  make(3, 990'000, 5, Side::BID);
+  std::size_t free_slots = pool.available();
+
+  // Refused amends leave the order as it was
+  REQUIRE_EQ(book.replace_order(2, 990'005, 5), OrderBook::REJECTED);
+  REQUIRE_EQ(book.replace_order(99, 990'000, 5), OrderBook::REJECTED);
+  REQUIRE_EQ(bid->price, static_cast<int64_t>(990'000));
+
+  // Re-priced below the ask: rests at the back of the new level
+  REQUIRE_EQ(book.replace_order(2, 995'000, 6), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(995'000));
+
+  // Re-priced through the ask: trades on entry at the ask's price
+  REQUIRE_EQ(book.replace_order(2, 1'000'200, 8), static_cast<uint64_t>(8));
+  REQUIRE_EQ(ask->remaining_qty, static_cast<uint32_t>(2));
+  REQUIRE_EQ(bid->active, static_cast<uint8_t>(0));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(990'000));
+  REQUIRE_EQ(pool.available(), free_slots);
+
+  // Zero size cancels
+  REQUIRE_EQ(book.replace_order(3, 990'000, 0), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(0));
+}
+
+TEST_CASE(OrderBook_stops_fire_on_last_trade_and_cascade) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 16);
+  OrderBook book;
+
+  auto make = [&](uint64_t id, OrderType type, int64_t price, uint32_t qty,
+                  Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->type = type;
+    o->price = price;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    return o;
+  };
+  REQUIRE(book.add_order(make(1, OrderType::LIMIT, 1'000'100, 10, Side::ASK)));
+  REQUIRE(book.add_order(make(2, OrderType::LIMIT, 1'000'200, 10, Side::ASK)));
+
+  // Parked off-book: no trade yet, and neither touches the bid side
+  Order *stop = make(3, OrderType::STOP, 0, 5, Side::BID);
+  Order *stop_limit = make(4, OrderType::STOP_LIMIT, 1'000'200, 20, Side::BID);
+  REQUIRE_EQ(book.submit_stop(stop, 1'000'100), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_stop(stop_limit, 1'000'200), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_stop(make(5, OrderType::STOP, 0, 1, Side::BID),
+                              1'000'105),
+             OrderBook::REJECTED); // off-tick trigger
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(0));
+
+  // A print at 1'000'100 fires the buy stop, which lifts the rest of the
+  // level; the stop-limit's trigger is not reached yet
+  REQUIRE_EQ(book.submit_limit(
+                 make(6, OrderType::LIMIT, 1'000'100, 5, Side::BID)),
+             static_cast<uint64_t>(10));
+  REQUIRE_EQ(stop->active, static_cast<uint8_t>(0));
+  REQUIRE_EQ(stop->remaining_qty, static_cast<uint32_t>(0));
+  REQUIRE_EQ(book.stops_triggered(), static_cast<uint64_t>(1));
+
+  // A print at 1'000'200 fires the stop-limit: it buys the 9 left at its
+  // price and rests the residual as a bid
+  REQUIRE_EQ(book.match_market(make(7, OrderType::MARKET, 0, 1, Side::BID)),
+             static_cast<uint64_t>(10));
+  REQUIRE_EQ(book.last_trade_price(), static_cast<int64_t>(1'000'200));
+  REQUIRE_EQ(book.stops_triggered(), static_cast<uint64_t>(2));
+  REQUIRE(stop_limit->type == OrderType::LIMIT);
+  REQUIRE_EQ(stop_limit->remaining_qty, static_cast<uint32_t>(11));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'000'200));
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(0));
+}
+
+TEST_CASE(OrderBook_parked_stop_cancels_and_reached_stop_runs_at_once) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 16);
+  OrderBook book;
+
+  auto make = [&](uint64_t id, OrderType type, int64_t price, uint32_t qty,
+                  Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->type = type;
+    o->price = price;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    return o;
+  };
+  REQUIRE(book.add_order(make(1, OrderType::LIMIT, 999'000, 10, Side::BID)));
+  REQUIRE(book.add_order(make(2, OrderType::LIMIT, 998'000, 10, Side::BID)));
+
+  // Cancelled while parked: a later print through its trigger does nothing
+  Order *parked = make(3, OrderType::STOP, 0, 10, Side::ASK);
+  REQUIRE_EQ(book.submit_stop(parked, 999'000), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.replace_order(3, 999'000, 5), OrderBook::REJECTED);
+  REQUIRE(book.cancel_order(3));
+  REQUIRE_EQ(book.match_market(make(4, OrderType::MARKET, 0, 4, Side::ASK)),
+             static_cast<uint64_t>(4));
+  REQUIRE_EQ(book.stops_triggered(), static_cast<uint64_t>(0));
+
+  // Last trade 999'000 is already at or below this trigger: it sells now,
+  // and what it cannot fill is dropped rather than parked
+  Order *reached = make(5, OrderType::STOP, 0, 30, Side::ASK);
+  REQUIRE_EQ(book.submit_stop(reached, 999'500), static_cast<uint64_t>(16));
+  REQUIRE_EQ(reached->active, static_cast<uint8_t>(0));
+  REQUIRE_EQ(reached->remaining_qty, static_cast<uint32_t>(14));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(0));
+  REQUIRE_EQ(book.stops_triggered(), static_cast<uint64_t>(1));
+}
+
+TEST_CASE(OrderBook_iceberg_crosses_full_size_then_rests_a_slice) {
+  MemoryArena arena(1024 * 1024);
+  MemoryArena ring_arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 16);
+  LockFreeRingBuffer<ExecutionReport> ring(ring_arena);
+  std::atomic<uint64_t> stalls{0};
+  ExecutionSink sink(ring, stalls);
+  OrderBook book;
+  book.set_execution_sink(&sink);
+
+  auto make = [&](uint64_t id, uint32_t qty, uint32_t peak, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = 1'000'000;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->peak_qty = peak;
+    o->side = side;
+    return o;
+  };
+  REQUIRE(book.add_order(make(1, 30, 0, Side::ASK)));
+
+  // Aggressing with 100 (10 shown): all 30 on offer trade at once
+  Order *iceberg = make(2, 100, 10, Side::BID);
+  REQUIRE_EQ(book.submit_limit(iceberg), static_cast<uint64_t>(30));
+  ExecutionReport r{};
+  REQUIRE(ring.pop(r));
+  REQUIRE_EQ(r.taker_leaves, static_cast<uint32_t>(70));
+  REQUIRE_EQ(iceberg->remaining_qty, static_cast<uint32_t>(10));
+  REQUIRE_EQ(iceberg->hidden_qty, static_cast<uint32_t>(60));
+
+  // Growing the reserve is invisible: still ahead of a later bid
+  Order *later = make(3, 10, 0, Side::BID);
+  REQUIRE(book.add_order(later));
+  REQUIRE_EQ(book.replace_order(2, 1'000'000, 90), static_cast<uint64_t>(0));
+  REQUIRE_EQ(iceberg->quantity, static_cast<uint32_t>(120)); // 30 + 90
+  REQUIRE_EQ(book.match_market(make(4, 12, 0, Side::ASK)),
+             static_cast<uint64_t>(12));
+  REQUIRE_EQ(later->remaining_qty, static_cast<uint32_t>(8)); // behind refill
+  REQUIRE_EQ(iceberg->remaining_qty + iceberg->hidden_qty,
+             static_cast<uint32_t>(80));
+
+  // Cancel pulls the reserve with the slice
+  REQUIRE(book.cancel_order(2));
+  REQUIRE_EQ(iceberg->hidden_qty, static_cast<uint32_t>(0));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'000'000));
+  REQUIRE(book.cancel_order(3));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(0));
+}
+
+TEST_CASE(ProRata_shares_are_exact_floors) {
+  std::mt19937_64 rng(17);
+  for (uint32_t shown : {1'000u, (1u << 26) - 1, 3'000'000'000u}) {
+    std::vector<uint32_t> open(61), shares(61);
+    for (auto &q : open)
+      q = static_cast<uint32_t>(rng() % (shown / 61 + 1));
+    auto units = static_cast<uint32_t>(rng() % shown);
+    ProRata::compute_shares(open.data(), shares.data(), open.size(), units,
+                            shown);
+    for (std::size_t i = 0; i < open.size(); ++i)
+      REQUIRE_EQ(shares[i],
+                 static_cast<uint32_t>(uint64_t{open[i]} * units / shown));
+  }
+}
+
+TEST_CASE(ProRataOrderBook_splits_by_size_after_top_order) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 16);
+  ProRataOrderBook book;
+
+  auto make = [&](uint64_t id, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = 1'000'000;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    return o;
+  };
+  Order *a = make(1, 50, Side::ASK);
+  Order *b = make(2, 100, Side::ASK);
+  Order *c = make(3, 300, Side::ASK);
+  Order *d = make(4, 50, Side::ASK);
+  for (Order *o : {a, b, c, d})
+    REQUIRE(book.add_order(o));
+
+  // Top order first (50, under the cap), then 200 over 450 shown:
+  // floors 44 / 133 / 22, and the 1 left over goes to the oldest (b)
+  REQUIRE_EQ(book.submit_limit(make(5, 250, Side::BID)),
+             static_cast<uint64_t>(250));
+  REQUIRE_EQ(a->remaining_qty, static_cast<uint32_t>(0));
+  REQUIRE_EQ(b->remaining_qty, static_cast<uint32_t>(55));
+  REQUIRE_EQ(c->remaining_qty, static_cast<uint32_t>(167));
+  REQUIRE_EQ(d->remaining_qty, static_cast<uint32_t>(28));
+  REQUIRE_EQ(book.match_count(), static_cast<uint64_t>(5));
+
+  // A taker bigger than the level clears it and rests the rest
+  REQUIRE_EQ(book.submit_limit(make(6, 300, Side::BID)),
+             static_cast<uint64_t>(250));
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(0));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'000'000));
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  9. InstrumentDirectory Tests
+// ═══════════════════════════════════════════════════════════════════════
+
+TEST_CASE(Directory_assigns_dense_slots) {
+  InstrumentDirectory dir;
+  REQUIRE_EQ(dir.add_instrument(500), static_cast<uint16_t>(0));
+  REQUIRE_EQ(dir.add_instrument(7), static_cast<uint16_t>(1));
+  REQUIRE_EQ(dir.add_instrument(500), static_cast<uint16_t>(0)); // idempotent
+  REQUIRE_EQ(dir.size(), static_cast<std::size_t>(2));
+  REQUIRE(dir.find(500) == &dir.book_at(0));
+  REQUIRE(dir.find(7) == &dir.book_at(1));
+}
+
+TEST_CASE(Directory_unknown_instrument_returns_null) {
+  InstrumentDirectory dir;
+  dir.add_instrument(1);
+  REQUIRE(dir.find(2) == nullptr);
+  REQUIRE(dir.find(config::INSTRUMENT_ID_SPACE) == nullptr);
+  REQUIRE_EQ(dir.add_instrument(config::INSTRUMENT_ID_SPACE),
+             InstrumentDirectory::INVALID_SLOT);
+}
+
+TEST_CASE(Directory_instruments_do_not_cross) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  InstrumentDirectory dir;
+  dir.add_instrument(1);
+  dir.add_instrument(2);
+
+  Order *bid = pool.acquire();
+  bid->id = 1;
+  bid->instrument_id = 1;
+  bid->price = 1000000;
+  bid->remaining_qty = 50;
+  bid->side = Side::BID;
+  dir.find(1)->add_order(bid);
+
+  Order *ask = pool.acquire();
+  ask->id = 2;
+  ask->instrument_id = 2;
+  ask->price = 1000000;
+  ask->remaining_qty = 50;
+  ask->side = Side::ASK;
+  dir.find(2)->add_order(ask);
+
+  // Same price, different instruments: neither book may trade
+  REQUIRE_EQ(dir.find(1)->match(), static_cast<uint64_t>(0));
+  REQUIRE_EQ(dir.find(2)->match(), static_cast<uint64_t>(0));
+  REQUIRE_EQ(bid->remaining_qty, static_cast<uint32_t>(50));
+  REQUIRE_EQ(ask->remaining_qty, static_cast<uint32_t>(50));
+}
+
+TEST_CASE(Directory_cancel_routes_by_order_id) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  InstrumentDirectory dir;
+  dir.add_instrument(3);
+  dir.add_instrument(4);
+
+  Order *o = pool.acquire();
+  o->id = 77;
+  o->instrument_id = 4;
+  o->price = 1000000;
+  o->remaining_qty = 10;
+  o->side = Side::ASK;
+  dir.find(4)->add_order(o);
+
+  REQUIRE(dir.cancel_order(77));
+  REQUIRE_EQ(o->active, static_cast<uint8_t>(0));
+  REQUIRE(!dir.cancel_order(77));
+  REQUIRE_EQ(dir.find(4)->cancel_count(), static_cast<uint64_t>(1));
+}
+
+TEST_CASE(Directory_cancel_unlinks_order_immediately) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 10);
+  InstrumentDirectory dir;
+  dir.add_instrument(0);
+
+  for (uint64_t id = 1; id <= 3; ++id) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = config::MID_PRICE;
+    o->remaining_qty = 10;
+    o->side = Side::BID;
+    dir.find(0)->add_order(o);
+  }
+
+  // Cancelling the middle order hands it to the graveyard right away
+  REQUIRE(dir.cancel_order(2));
+  REQUIRE_EQ(dir.pending_reclaim(), static_cast<std::size_t>(1));
+  REQUIRE_EQ(dir.reclaim(pool, 8), static_cast<std::size_t>(1));
+  REQUIRE_EQ(pool.in_use(), static_cast<std::size_t>(2));
+
+  // The survivors are still matched FIFO
+  Order *sell = pool.acquire();
+  sell->id = 9;
+  sell->remaining_qty = 15;
+  sell->side = Side::ASK;
+  REQUIRE_EQ(dir.find(0)->match_market(sell), static_cast<uint64_t>(15));
+  REQUIRE_EQ(dir.find(0)->best_bid_price(), config::MID_PRICE);
+  REQUIRE(!dir.cancel_order(1)); // filled
+  REQUIRE(dir.cancel_order(3));  // 5 left, now the head
+  REQUIRE_EQ(dir.find(0)->best_bid_price(), static_cast<int64_t>(0));
+}
+
+TEST_CASE(Directory_reclaims_dead_orders_in_constant_memory) {
+  // 16 slots, 500K orders: only works if every filled or cancelled order
+  // makes it back to the pool
+  constexpr std::size_t SLOTS = 16;
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, SLOTS);
+  InstrumentDirectory dir;
+  dir.add_instrument(0);
+  OrderBook *book = dir.find(0);
+
+  uint64_t next_id = 1;
+  auto add = [&](int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    REQUIRE(o != nullptr);
+    o->id = next_id++;
+    o->price = price;
+    o->remaining_qty = qty;
+    o->side = side;
+    REQUIRE(book->add_order(o));
+    book->match();
+    dir.reclaim(pool, config::RECLAIM_BATCH);
+    return o->id;
+  };
+
+  for (int i = 0; i < 100'000; ++i) {
+    auto qty = static_cast<uint32_t>(2 + i % 7);
+    int64_t bid = config::MID_PRICE - (i % 3) * 10;
+
+    uint64_t partial = add(bid, qty, Side::BID);
+    add(bid, qty - 1, Side::ASK);       // taker fully filled
+    REQUIRE(dir.cancel_order(partial)); // cancel drains the level
+    uint64_t head = add(bid, qty, Side::BID);
+    add(bid, qty, Side::BID);
+    REQUIRE(dir.cancel_order(head));    // dead head unlinked eagerly
+    add(bid - 10, qty, Side::ASK);      // fills the order behind it
+    REQUIRE_EQ(book->best_bid_price(), static_cast<int64_t>(0));
+  }
+
+  while (dir.reclaim(pool, config::RECLAIM_BATCH) > 0) {
+  }
+  REQUIRE_EQ(dir.pending_reclaim(), static_cast<std::size_t>(0));
+  REQUIRE_EQ(pool.in_use(), static_cast<std::size_t>(0));
+}
+
+TEST_CASE(Directory_idle_sweep_picks_up_filled_heads_within_budget) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 64);
+  InstrumentDirectory dir;
+  dir.add_instrument(1);
+  dir.add_instrument(2);
+
+  uint64_t next_id = 1;
+  auto add = [&](uint64_t instrument, int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->instrument_id = instrument;
+    o->price = price;
+    o->remaining_qty = qty;
+    o->side = side;
+    REQUIRE(dir.find(instrument)->add_order(o));
+    dir.find(instrument)->match();
+    return o->id;
+  };
+
+  // Each ask level ends with a filled head that no later match walks past
+  std::vector<uint64_t> survivors;
+  for (uint64_t instrument : {1, 2}) {
+    for (int64_t price : {1'000'200, 1'000'100, 1'000'000}) {
+      add(instrument, price, 5, Side::ASK);
+      survivors.push_back(add(instrument, price, 5, Side::ASK));
+      add(instrument, price, 5, Side::BID);
+    }
+  }
+  std::size_t drained = dir.pending_reclaim(); // the filled bids
+  REQUIRE_EQ(drained, static_cast<std::size_t>(6));
+
+  // One unit per call: never more than one order per poll
+  std::size_t swept = 0;
+  for (int poll = 0; poll < 100; ++poll) {
+    std::size_t moved = dir.compact(1);
+    REQUIRE(moved <= 1);
+    swept += moved;
+  }
+  REQUIRE_EQ(swept, static_cast<std::size_t>(6));
+  REQUIRE_EQ(dir.pending_reclaim(), drained + 6);
+  REQUIRE_EQ(dir.compact(64), static_cast<std::size_t>(0)); // nothing left
+
+  // The live orders behind them are untouched
+  REQUIRE_EQ(dir.find(1)->best_ask_price(), static_cast<int64_t>(1'000'000));
+  for (uint64_t id : survivors)
+    REQUIRE(dir.cancel_order(id));
+  REQUIRE_EQ(dir.find(2)->best_ask_price(), static_cast<int64_t>(0));
+}
+
+TEST_CASE(Directory_mass_cancel_pulls_only_that_owners_orders) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 64);
+  InstrumentDirectory dir(pool.capacity());
+  dir.track_owners(pool);
+  dir.add_instrument(1);
+  dir.add_instrument(2);
+
+  auto submit = [&](uint64_t id, uint64_t instrument, uint32_t owner,
+                    Side side, int64_t price, uint32_t qty) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->instrument_id = instrument;
+    o->owner_id = owner;
+    o->side = side;
+    o->price = price;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    return dir.submit_limit(*dir.find(instrument), o);
+  };
+
+  // Owner 7's order 6 trades fully against owner 9's bid: dead, not reclaimed
+  REQUIRE_EQ(submit(2, 1, 9, Side::BID, 999'990, 20), uint64_t{0});
+  REQUIRE_EQ(submit(6, 1, 7, Side::ASK, 999'990, 10), uint64_t{10});
+  // Then owner 7 quotes the top of both books, owner 9 behind it
+  REQUIRE_EQ(submit(1, 1, 7, Side::BID, 1'000'000, 10), uint64_t{0});
+  REQUIRE_EQ(submit(3, 2, 7, Side::ASK, 1'000'100, 10), uint64_t{0});
+  REQUIRE_EQ(submit(4, 2, 9, Side::ASK, 1'000'200, 10), uint64_t{0});
+  REQUIRE_EQ(submit(5, 1, 7, Side::ASK, 1'000'500, 10), uint64_t{0});
+
+  REQUIRE_EQ(dir.mass_cancel(7), static_cast<std::size_t>(3));
+  REQUIRE_EQ(dir.find(1)->best_bid_price(), static_cast<int64_t>(999'990));
+  REQUIRE_EQ(dir.find(1)->best_ask_price(), static_cast<int64_t>(0));
+  REQUIRE_EQ(dir.find(2)->best_ask_price(), static_cast<int64_t>(1'000'200));
+  REQUIRE_EQ(dir.mass_cancel(7), static_cast<std::size_t>(0)); // idempotent
+  REQUIRE_EQ(dir.mass_cancel(0), static_cast<std::size_t>(0)); // untracked
+
+  // Reclaiming takes the dead orders off the chains for good: slots reused
+  // by another owner are not cancelled with owner 7
+  while (dir.reclaim(pool, 64) > 0) {
+  }
+  REQUIRE_EQ(submit(10, 1, 3, Side::BID, 999'000, 5), uint64_t{0});
+  REQUIRE_EQ(dir.mass_cancel(7), static_cast<std::size_t>(0));
+  REQUIRE_EQ(dir.mass_cancel(9), static_cast<std::size_t>(2));
+  REQUIRE_EQ(dir.find(1)->best_bid_price(), static_cast<int64_t>(999'000));
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  10. Sharding Tests
+// ═══════════════════════════════════════════════════════════════════════
+
+TEST_CASE(Shard_registers_only_owned_instruments) {
+  MatcherShard shard(100, config::MATCHER_CORE_ID);
+  shard.register_instruments(1, 4, 100);
+  auto &dir = shard.matcher.instruments();
+  REQUIRE_EQ(dir.size(), static_cast<std::size_t>(25));
+  REQUIRE(dir.find(1) != nullptr);
+  REQUIRE(dir.find(97) != nullptr);
+  REQUIRE(dir.find(0) == nullptr);
+  REQUIRE(dir.find(2) == nullptr);
+}
+
+TEST_CASE(Gateway_routes_orders_and_cancels_by_instrument) {
+  constexpr std::size_t SHARDS = 3;
+  constexpr std::size_t ORDERS = 2000;
+  std::vector<std::unique_ptr<MatcherShard>> shards;
+  std::vector<ShardLink> links;
+  for (std::size_t i = 0; i < SHARDS; ++i) {
+    shards.push_back(std::make_unique<MatcherShard>(ORDERS, 0));
+    links.push_back(
+        ShardLink{&shards[i]->ring, &shards[i]->pool, &shards[i]->stats});
+  }
+
+  // Run the gateway synchronously; the rings are large enough to hold it all
+  GatewaySimulator gateway(links, ORDERS);
+  gateway();
+
+  // Pass 1: drain every ring, check order routing, record instruments
+  std::vector<std::vector<OrderMessage>> drained(SHARDS);
+  std::vector<uint64_t> instrument_of(ORDERS + 1, UINT64_MAX);
+  std::size_t received = 0;
+  for (std::size_t i = 0; i < SHARDS; ++i) {
+    received += shards[i]->stats.orders_received.load();
+    OrderMessage msg{};
+    while (shards[i]->ring.pop(msg)) {
+      drained[i].push_back(msg);
+      if (msg.order) { // CANCEL and REPLACE carry only an order ID
+        REQUIRE_EQ(shard_of(msg.order->instrument_id, SHARDS), i);
+        instrument_of[msg.order->id] = msg.order->instrument_id;
+      }
+    }
+  }
+
+  // Pass 2: a cancel or replace for an issued ID must land on that order's
+  // shard
+  std::size_t cancels = 0;
+  std::size_t replaces = 0;
+  std::size_t broadcasts = 0; // MASS_CANCEL copies beyond the first
+  for (std::size_t i = 0; i < SHARDS; ++i) {
+    for (const auto &msg : drained[i]) {
+      if (msg.type == OrderType::MASS_CANCEL) {
+        broadcasts += (i > 0);
+        continue;
+      }
+      if (msg.order || instrument_of[msg.target_id] == UINT64_MAX)
+        continue;
+      ++(msg.type == OrderType::CANCEL ? cancels : replaces);
+      REQUIRE_EQ(shard_of(instrument_of[msg.target_id], SHARDS), i);
+    }
+  }
+  REQUIRE_EQ(received, ORDERS + broadcasts);
+  REQUIRE(cancels > 0);
+  REQUIRE(replaces > 0);
+}
+
+TEST_CASE(Gateways_sharing_a_ring_issue_disjoint_ids_and_sessions) {
+  constexpr std::size_t GATEWAYS = 3;
+  constexpr std::size_t ORDERS = 1000; // per gateway
+  MatcherShard shard(GATEWAYS * ORDERS, 0);
+  std::vector<ShardLink> links{
+      ShardLink{&shard.ring, &shard.pool, &shard.stats}};
+
+  std::vector<bool> issued(GATEWAYS * ORDERS + 1, false);
+  std::size_t orders = 0;
+  for (std::size_t k = 0; k < GATEWAYS; ++k) {
+    GatewaySimulator gateway(links, ORDERS, k, GATEWAYS);
+    gateway();
+
+    // Every ID, target and session named by gateway k is k+1 mod GATEWAYS
+    OrderMessage msg{};
+    std::size_t drained = 0;
+    while (shard.ring.pop(msg)) {
+      ++drained;
+      if (msg.order) {
+        REQUIRE_EQ((msg.order->id - 1) % GATEWAYS, k);
+        REQUIRE_EQ((msg.order->owner_id - 1) % GATEWAYS, k);
+        REQUIRE(!issued[msg.order->id]);
+        issued[msg.order->id] = true;
+        ++orders;
+      } else { // CANCEL / REPLACE target, or MASS_CANCEL session
+        REQUIRE_EQ((msg.target_id - 1) % GATEWAYS, k);
+      }
+    }
+    REQUIRE_EQ(drained, ORDERS);
+  }
+  REQUIRE(orders > GATEWAYS * ORDERS / 2);
+  REQUIRE_EQ(shard.stats.orders_received.load(), GATEWAYS * ORDERS);
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  11. Execution Report Tests
+// ═══════════════════════════════════════════════════════════════════════
+
+TEST_CASE(Execution_one_report_per_fill_at_maker_price) {
+  MemoryArena arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  LockFreeRingBuffer<ExecutionReport> ring(arena);
+  std::atomic<uint64_t> stalls{0};
+  ExecutionSink sink(ring, stalls);
+  OrderBook book;
+  book.set_execution_sink(&sink);
+
+  auto make = [&](uint64_t id, int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->instrument_id = 7;
+    o->price = price;
+    o->remaining_qty = qty;
+    o->side = side;
+    o->timestamp = 1000 + id;
+    return o;
+  };
+
+  book.add_order(make(1, 1'000'000, 5, Side::ASK));
+  book.add_order(make(2, 1'000'010, 5, Side::ASK));
+  book.add_order(make(3, 1'000'010, 8, Side::BID)); // sweeps both asks
+  REQUIRE_EQ(book.match(), static_cast<uint64_t>(8));
+
+  ExecutionReport r{};
+  REQUIRE(ring.pop(r));
+  REQUIRE_EQ(r.maker_order_id, static_cast<uint64_t>(1));
+  REQUIRE_EQ(r.taker_order_id, static_cast<uint64_t>(3));
+  REQUIRE_EQ(r.instrument_id, static_cast<uint64_t>(7));
+  REQUIRE_EQ(r.price, static_cast<int64_t>(1'000'000));
+  REQUIRE_EQ(r.quantity, static_cast<uint32_t>(5));
+  REQUIRE_EQ(r.maker_leaves, static_cast<uint32_t>(0));
+  REQUIRE_EQ(r.taker_leaves, static_cast<uint32_t>(3));
+  REQUIRE(r.taker_side == Side::BID);
+  REQUIRE_EQ(r.taker_timestamp, static_cast<uint64_t>(1003));
+  uint64_t first_ts = r.match_timestamp;
+  REQUIRE(first_ts > 0);
+
+  REQUIRE(ring.pop(r));
+  REQUIRE_EQ(r.maker_order_id, static_cast<uint64_t>(2));
+  REQUIRE_EQ(r.price, static_cast<int64_t>(1'000'010));
+  REQUIRE_EQ(r.quantity, static_cast<uint32_t>(3));
+  REQUIRE_EQ(r.maker_leaves, static_cast<uint32_t>(2));
+  REQUIRE_EQ(r.taker_leaves, static_cast<uint32_t>(0));
+  REQUIRE_EQ(r.match_timestamp, first_ts); // one clock read per match()
+  REQUIRE(!ring.pop(r));
+
+  // Sell aggressor: the ask is the taker and prints at the resting bid
+  book.add_order(make(4, 1'000'000, 4, Side::BID));
+  book.add_order(make(5, 990'000, 1, Side::ASK));
+  REQUIRE_EQ(book.match(), static_cast<uint64_t>(1));
+  REQUIRE(ring.pop(r));
+  REQUIRE_EQ(r.maker_order_id, static_cast<uint64_t>(4));
+  REQUIRE_EQ(r.taker_order_id, static_cast<uint64_t>(5));
+  REQUIRE_EQ(r.price, static_cast<int64_t>(1'000'000));
+  REQUIRE(r.taker_side == Side::ASK);
+  REQUIRE_EQ(stalls.load(), static_cast<uint64_t>(0));
+}
+
+TEST_CASE(Execution_market_order_reports_each_maker) {
+  MemoryArena arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  LockFreeRingBuffer<ExecutionReport> ring(arena);
+  std::atomic<uint64_t> stalls{0};
+  ExecutionSink sink(ring, stalls);
+  InstrumentDirectory dir;
+  dir.set_execution_sink(&sink); // applies to books registered later
+  dir.add_instrument(1);
+
+  for (uint64_t id = 1; id <= 3; ++id) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->instrument_id = 1;
+    o->price = 1'000'000;
+    o->remaining_qty = 10;
+    o->side = Side::BID;
+    dir.find(1)->add_order(o);
+  }
+  REQUIRE(dir.cancel_order(2)); // skipped: no report for a dead maker
+
+  Order *sell = pool.acquire();
+  sell->id = 9;
+  sell->instrument_id = 1;
+  sell->remaining_qty = 15;
+  sell->side = Side::ASK;
+  sell->type = OrderType::MARKET;
+  REQUIRE_EQ(dir.find(1)->match_market(sell), static_cast<uint64_t>(15));
+
+  ExecutionReport r{};
+  uint64_t makers[2] = {1, 3};
+  uint32_t qtys[2] = {10, 5};
+  for (int i = 0; i < 2; ++i) {
+    REQUIRE(ring.pop(r));
+    REQUIRE_EQ(r.maker_order_id, makers[i]);
+    REQUIRE_EQ(r.taker_order_id, static_cast<uint64_t>(9));
+    REQUIRE_EQ(r.quantity, qtys[i]);
+  }
+  REQUIRE(!ring.pop(r));
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  12. Call Auction Tests
+// ═══════════════════════════════════════════════════════════════════════
+
+TEST_CASE(Auction_simd_search_matches_scalar) {
+  std::mt19937_64 rng(16);
+  for (std::size_t n : {8, 64, 1'000, 4'096}) {
+    for (int round = 0; round < 20; ++round) {
+      // Sparse, small quantities: plenty of volume and imbalance ties
+      std::vector<double> bids(n), asks(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        bids[i] = (rng() % 3 == 0) ? static_cast<double>(rng() % 4) : 0;
+        asks[i] = (rng() % 3 == 0) ? static_cast<double>(rng() % 4) : 0;
+      }
+      std::size_t ref = rng() % n;
+      std::vector<double> scalar_bids = bids;
+      auto expect =
+          auction::find_equilibrium_scalar(scalar_bids.data(), asks.data(), n,
+                                           ref);
+      auto got = auction::find_equilibrium(bids.data(), asks.data(), n, ref);
+      REQUIRE_EQ(got.volume, expect.volume);
+      REQUIRE_EQ(got.imbalance, expect.imbalance);
+      if (expect.volume > 0)
+        REQUIRE_EQ(got.index, expect.index);
+    }
+  }
+}
+
+TEST_CASE(OrderBook_auction_accumulates_then_uncrosses_at_one_price) {
+  MemoryArena arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  LockFreeRingBuffer<ExecutionReport> ring(arena);
+  std::atomic<uint64_t> stalls{0};
+  ExecutionSink sink(ring, stalls);
+  OrderBook book;
+  book.set_execution_sink(&sink);
+
+  auto make = [&](uint64_t id, int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = price;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    return o;
+  };
+
+  book.begin_auction();
+  REQUIRE(book.in_auction());
+  REQUIRE_EQ(book.submit_limit(make(1, 1'000'030, 10, Side::BID)),
+             static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_limit(make(2, 1'000'020, 20, Side::BID)),
+             static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_limit(make(3, 1'000'000, 30, Side::BID)),
+             static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_limit(make(4, 999'990, 15, Side::ASK)),
+             static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_limit(make(5, 1'000'010, 25, Side::ASK)),
+             static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_limit(make(6, 1'000'030, 40, Side::ASK)),
+             static_cast<uint64_t>(0));
+  Order *market = make(7, 0, 5, Side::BID);
+  market->type = OrderType::MARKET;
+  REQUIRE_EQ(book.match_market(market), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.match(), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'000'030)); // crossed
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(999'990));
+
+  // 30 trades at both 1'000'010 and 1'000'020, imbalance 10 at each; the
+  // middle of the crossing range breaks the tie
+  AuctionQuote quote = book.auction_quote();
+  REQUIRE_EQ(quote.price, static_cast<int64_t>(1'000'010));
+  REQUIRE_EQ(quote.volume, static_cast<uint64_t>(30));
+  REQUIRE_EQ(quote.imbalance, static_cast<uint64_t>(10));
+
+  REQUIRE_EQ(book.uncross(), static_cast<uint64_t>(30));
+  REQUIRE(!book.in_auction());
+  ExecutionReport r{};
+  uint64_t bids[3] = {1, 2, 2};
+  uint64_t asks[3] = {4, 4, 5};
+  uint32_t qtys[3] = {10, 5, 15};
+  for (int i = 0; i < 3; ++i) {
+    REQUIRE(ring.pop(r));
+    REQUIRE_EQ(r.taker_order_id, bids[i]);
+    REQUIRE_EQ(r.maker_order_id, asks[i]);
+    REQUIRE_EQ(r.quantity, qtys[i]);
+    REQUIRE_EQ(r.price, static_cast<int64_t>(1'000'010));
+  }
+  REQUIRE(!ring.pop(r));
+
+  // Residual is uncrossed and trades continuously again
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(1'000'000));
+  REQUIRE_EQ(book.best_ask_price(), static_cast<int64_t>(1'000'010));
+  REQUIRE_EQ(book.last_trade_price(), static_cast<int64_t>(1'000'010));
+  REQUIRE_EQ(book.submit_limit(make(8, 1'000'010, 4, Side::BID)),
+             static_cast<uint64_t>(4));
+}
+
+TEST_CASE(OrderBook_reached_stop_waits_for_the_uncross_in_an_auction) {
+  MemoryArena arena(1024 * 1024);
+  ObjectPool<Order> pool(arena, 16);
+  OrderBook book;
+
+  auto make = [&](uint64_t id, OrderType type, int64_t price, uint32_t qty,
+                  Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->type = type;
+    o->price = price;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->side = side;
+    return o;
+  };
+  REQUIRE_EQ(book.submit_limit(make(1, OrderType::LIMIT, 1'000'000, 10,
+                                    Side::BID)),
+             static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_limit(make(2, OrderType::LIMIT, 1'000'000, 5,
+                                    Side::ASK)),
+             static_cast<uint64_t>(5));
+
+  // Last trade 1'000'000 has reached this buy stop, but nothing trades in
+  // the call phase: it parks instead of being dropped
+  book.begin_auction();
+  Order *buy_stop = make(3, OrderType::STOP, 0, 3, Side::BID);
+  REQUIRE_EQ(book.submit_stop(buy_stop, 999'990), static_cast<uint64_t>(0));
+  REQUIRE_EQ(buy_stop->active, static_cast<uint8_t>(1));
+  REQUIRE_EQ(book.stops_triggered(), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_limit(make(4, OrderType::LIMIT, 999'990, 4,
+                                    Side::ASK)),
+             static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.submit_limit(make(5, OrderType::LIMIT, 1'000'010, 8,
+                                    Side::ASK)),
+             static_cast<uint64_t>(0));
+
+  // The uncross trades 4, then the stop buys 3 from the residual book
+  REQUIRE_EQ(book.uncross(), static_cast<uint64_t>(7));
+  REQUIRE_EQ(book.stops_triggered(), static_cast<uint64_t>(1));
+  REQUIRE_EQ(buy_stop->remaining_qty, static_cast<uint32_t>(0));
+  REQUIRE_EQ(book.last_trade_price(), static_cast<int64_t>(1'000'010));
+
+  // An auction that does not cross still runs the stops it held back
+  book.begin_auction();
+  REQUIRE_EQ(book.submit_limit(make(6, OrderType::LIMIT, 999'000, 3,
+                                    Side::BID)),
+             static_cast<uint64_t>(0));
+  Order *sell_stop = make(7, OrderType::STOP, 0, 2, Side::ASK);
+  REQUIRE_EQ(book.submit_stop(sell_stop, 1'000'020), static_cast<uint64_t>(0));
+  REQUIRE_EQ(book.uncross(), static_cast<uint64_t>(2));
+  REQUIRE_EQ(book.stops_triggered(), static_cast<uint64_t>(2));
+  REQUIRE_EQ(book.best_bid_price(), static_cast<int64_t>(999'000));
+}
+
+// ═══════════════════════════════════════════════════════════════════════
+//  13. Market Data Tests
+// ═══════════════════════════════════════════════════════════════════════
+
+TEST_CASE(MarketData_one_delta_per_level_per_message) {
+  MemoryArena arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  LockFreeRingBuffer<LevelDelta> ring(arena);
+  std::atomic<uint64_t> drops{0};
+  MarketDataSink feed(ring, drops);
+  OrderBook book;
+  book.set_market_data_sink(&feed, 9);
+
+  auto make = [&](uint64_t id, int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = price;
+    o->remaining_qty = qty;
+    o->side = side;
+    return o;
+  };
+
+  // Three asks at one price, two at the next: still one delta per level
+  for (uint64_t id = 1; id <= 3; ++id)
+    book.add_order(make(id, 1'000'000, 10, Side::ASK));
+  book.add_order(make(4, 1'000'010, 10, Side::ASK));
+  book.add_order(make(5, 1'000'010, 10, Side::ASK));
+  REQUIRE_EQ(feed.pending(), static_cast<std::size_t>(2));
+  feed.flush();
+
+  LevelDelta d{};
+  REQUIRE(ring.pop(d));
+  REQUIRE_EQ(d.sequence, static_cast<uint64_t>(1));
+  REQUIRE_EQ(d.price, static_cast<int64_t>(1'000'000));
+  REQUIRE_EQ(d.quantity, static_cast<uint32_t>(30));
+  REQUIRE_EQ(d.instrument_id, static_cast<uint16_t>(9));
+  REQUIRE(d.side == Side::ASK);
+  REQUIRE(ring.pop(d));
+  REQUIRE_EQ(d.sequence, static_cast<uint64_t>(2));
+  REQUIRE_EQ(d.quantity, static_cast<uint32_t>(20));
+  REQUIRE(!ring.pop(d));
+
+  // A buy clearing the first level and part of the second, then a bid
+  // resting below: the emptied level reads 0, the others their final size
+  REQUIRE_EQ(book.submit_limit(make(6, 1'000'010, 45, Side::BID)),
+             static_cast<uint64_t>(45));
+  REQUIRE_EQ(book.submit_limit(make(7, 990'000, 4, Side::BID)),
+             static_cast<uint64_t>(0));
+  feed.flush();
+  REQUIRE(ring.pop(d));
+  REQUIRE_EQ(d.price, static_cast<int64_t>(1'000'000));
+  REQUIRE_EQ(d.quantity, static_cast<uint32_t>(0));
+  REQUIRE(ring.pop(d));
+  REQUIRE_EQ(d.price, static_cast<int64_t>(1'000'010));
+  REQUIRE_EQ(d.quantity, static_cast<uint32_t>(5));
+  REQUIRE(ring.pop(d));
+  REQUIRE(d.side == Side::BID);
+  REQUIRE_EQ(d.quantity, static_cast<uint32_t>(4));
+  REQUIRE_EQ(d.sequence, static_cast<uint64_t>(5));
+
+  // Cancel and amend mark their level too
+  REQUIRE(book.cancel_order(7));
+  feed.flush();
+  REQUIRE(ring.pop(d));
+  REQUIRE_EQ(d.price, static_cast<int64_t>(990'000));
+  REQUIRE_EQ(d.quantity, static_cast<uint32_t>(0));
+  REQUIRE_EQ(book.replace_order(5, 1'000'010, 2), static_cast<uint64_t>(0));
+  feed.flush();
+  REQUIRE(ring.pop(d));
+  REQUIRE_EQ(d.quantity, static_cast<uint32_t>(2));
+  REQUIRE(!ring.pop(d));
+  REQUIRE_EQ(drops.load(), static_cast<uint64_t>(0));
+}
+
+TEST_CASE(MarketData_full_ring_drops_and_leaves_a_sequence_gap) {
+  MemoryArena arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  LockFreeRingBuffer<LevelDelta> ring(arena);
+  std::atomic<uint64_t> drops{0};
+  MarketDataSink feed(ring, drops);
+  InstrumentDirectory dir;
+  dir.set_market_data_sink(&feed);
+  dir.add_instrument(3);
+
+  // Nobody drains the ring: the matcher keeps going and counts the loss
+  LevelDelta filler{};
+  while (ring.push(filler)) {
+  }
+  Order *o = pool.acquire();
+  o->id = 1;
+  o->instrument_id = 3;
+  o->price = 1'000'000;
+  o->remaining_qty = 10;
+  o->side = Side::BID;
+  REQUIRE(dir.find(3)->add_order(o));
+  dir.flush_market_data();
+  REQUIRE_EQ(drops.load(), static_cast<uint64_t>(1));
+
+  LevelDelta d{};
+  while (ring.pop(d)) {
+  }
+  REQUIRE(dir.cancel_order(1));
+  dir.flush_market_data();
+  REQUIRE(ring.pop(d));
+  REQUIRE_EQ(d.sequence, static_cast<uint64_t>(2)); // 1 was dropped
+  REQUIRE_EQ(d.instrument_id, static_cast<uint16_t>(3));
+  REQUIRE_EQ(d.quantity, static_cast<uint32_t>(0));
+  REQUIRE_EQ(feed.sequence(), static_cast<uint64_t>(2));
+}
+
+TEST_CASE(OrderFeed_reports_every_change_to_a_resting_order) {
+  MemoryArena arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 16);
+  LockFreeRingBuffer<OrderEvent> ring(arena);
+  std::atomic<uint64_t> drops{0};
+  OrderFeedSink feed(ring, drops);
+  OrderBook book;
+  book.set_order_feed_sink(&feed);
+
+  auto submit = [&](uint64_t id, int64_t price, uint32_t qty, uint32_t peak,
+                    Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->price = price;
+    o->quantity = qty;
+    o->remaining_qty = qty;
+    o->peak_qty = peak;
+    o->side = side;
+    return book.submit_limit(o);
+  };
+  uint64_t expected_sequence = 0;
+  auto expect = [&](OrderEventType type, uint64_t id, int64_t price,
+                    uint32_t qty) {
+    OrderEvent e{};
+    REQUIRE(ring.pop(e));
+    REQUIRE_EQ(e.sequence, ++expected_sequence);
+    REQUIRE(e.type == type);
+    REQUIRE_EQ(e.order_id, id);
+    REQUIRE_EQ(e.price, price);
+    REQUIRE_EQ(e.quantity, qty);
+  };
+
+  submit(1, 1'000'000, 25, 10, Side::ASK); // iceberg: only the slice shows
+  submit(2, 1'000'000, 5, 0, Side::ASK);
+  expect(OrderEventType::ADD, 1, 1'000'000, 10);
+  expect(OrderEventType::ADD, 2, 1'000'000, 5);
+
+  // The slice trades out and the refill goes behind order 2
+  REQUIRE_EQ(submit(3, 1'000'000, 12, 0, Side::BID), static_cast<uint64_t>(12));
+  expect(OrderEventType::EXECUTE, 1, 1'000'000, 10);
+  expect(OrderEventType::ADD, 1, 1'000'000, 10);
+  expect(OrderEventType::EXECUTE, 2, 1'000'000, 2);
+
+  // Size down keeps priority; size up is a new queue position
+  REQUIRE_EQ(book.replace_order(2, 1'000'000, 1), static_cast<uint64_t>(0));
+  expect(OrderEventType::MODIFY, 2, 1'000'000, 1);
+  submit(4, 1'000'010, 4, 0, Side::ASK);
+  REQUIRE_EQ(book.replace_order(4, 1'000'010, 9), static_cast<uint64_t>(0));
+  expect(OrderEventType::ADD, 4, 1'000'010, 4);
+  expect(OrderEventType::CANCEL, 4, 1'000'010, 4);
+  expect(OrderEventType::ADD, 4, 1'000'010, 9);
+
+  // Repricing leaves one level and joins another
+  REQUIRE_EQ(book.replace_order(4, 1'000'020, 9), static_cast<uint64_t>(0));
+  expect(OrderEventType::CANCEL, 4, 1'000'010, 9);
+  expect(OrderEventType::ADD, 4, 1'000'020, 9);
+
+  REQUIRE(book.cancel_order(1));
+  expect(OrderEventType::CANCEL, 1, 1'000'000, 10);
+  OrderEvent e{};
+  REQUIRE(!ring.pop(e));
+  REQUIRE_EQ(feed.sequence(), expected_sequence);
+  REQUIRE_EQ(drops.load(), static_cast<uint64_t>(0));
+}
+
+TEST_CASE(OrderFeed_full_ring_drops_and_leaves_a_sequence_gap) {
+  MemoryArena arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  LockFreeRingBuffer<OrderEvent> ring(arena);
+  std::atomic<uint64_t> drops{0};
+  OrderFeedSink feed(ring, drops);
+  InstrumentDirectory dir;
+  dir.add_instrument(3);
+  dir.set_order_feed_sink(&feed); // reaches books already listed
+
+  OrderEvent filler{};
+  while (ring.push(filler)) {
+  }
+  Order *o = pool.acquire();
+  o->id = 1;
+  o->instrument_id = 3;
+  o->price = 1'000'000;
+  o->remaining_qty = 10;
+  o->side = Side::BID;
+  REQUIRE(dir.find(3)->add_order(o));
+  REQUIRE_EQ(drops.load(), static_cast<uint64_t>(1));
+
+  OrderEvent e{};
+  while (ring.pop(e)) {
+  }
+  REQUIRE(dir.cancel_order(1));
+  REQUIRE(ring.pop(e));
+  REQUIRE_EQ(e.sequence, static_cast<uint64_t>(2)); // 1 was dropped
+  REQUIRE(e.type == OrderEventType::CANCEL);
+  REQUIRE_EQ(e.instrument_id, static_cast<uint16_t>(3));
+  REQUIRE_EQ(e.quantity, static_cast<uint32_t>(10));
+}
+
+TEST_CASE(TopOfBook_republished_only_when_l1_changes) {
+  MemoryArena arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  InstrumentDirectory dir;
+  dir.add_instrument(4);
+  const TopOfBookCell *cell = dir.top_of_book(4);
+  REQUIRE(cell != nullptr);
+  REQUIRE(dir.top_of_book(5) == nullptr);
+  REQUIRE_EQ(cell->read().sequence, static_cast<uint64_t>(0));
+
+  auto submit = [&](uint64_t id, int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->instrument_id = 4;
+    o->price = price;
+    o->remaining_qty = qty;
+    o->side = side;
+    uint64_t filled = dir.submit_limit(*dir.find(4), o);
+    dir.flush_market_data(); // end of message
+    return filled;
+  };
+
+  submit(1, 1'000'000, 10, Side::BID);
+  submit(2, 1'000'020, 7, Side::ASK);
+  TopOfBook top = cell->read();
+  REQUIRE_EQ(top.sequence, static_cast<uint64_t>(2));
+  REQUIRE_EQ(top.bid_price, static_cast<int64_t>(1'000'000));
+  REQUIRE_EQ(top.bid_qty, static_cast<uint32_t>(10));
+  REQUIRE_EQ(top.ask_price, static_cast<int64_t>(1'000'020));
+  REQUIRE_EQ(top.ask_qty, static_cast<uint32_t>(7));
+  REQUIRE_EQ(top.last_trade_price, static_cast<int64_t>(0));
+
+  // Behind the best bid: L2 changes, L1 does not, the cell is not written
+  submit(3, 990'000, 5, Side::BID);
+  REQUIRE_EQ(cell->read().sequence, static_cast<uint64_t>(2));
+
+  // A trade moves size and last trade in one update
+  REQUIRE_EQ(submit(4, 1'000'000, 4, Side::ASK), static_cast<uint64_t>(4));
+  top = cell->read();
+  REQUIRE_EQ(top.sequence, static_cast<uint64_t>(3));
+  REQUIRE_EQ(top.bid_qty, static_cast<uint32_t>(6));
+  REQUIRE_EQ(top.last_trade_price, static_cast<int64_t>(1'000'000));
+
+  REQUIRE(dir.cancel_order(1));
+  dir.flush_market_data();
+  top = cell->read();
+  REQUIRE_EQ(top.bid_price, static_cast<int64_t>(990'000));
+  REQUIRE_EQ(top.bid_qty, static_cast<uint32_t>(5));
+}
+
+TEST_CASE(TopOfBook_reader_never_sees_a_torn_snapshot) {
+  constexpr uint32_t UPDATES = 200'000;
+  TopOfBookCell cell;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    for (uint32_t i = 1; i <= UPDATES; ++i) {
+      TopOfBook top;
+      top.bid_price = i;
+      top.ask_price = int64_t{i} + 1;
+      top.last_trade_price = int64_t{i} * 2;
+      top.bid_qty = i;
+      top.ask_qty = ~i;
+      cell.publish(top);
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint64_t last_sequence = 0;
+  bool consistent = true;
+  for (bool finished = false; !finished;) {
+    finished = done.load(std::memory_order_acquire);
+    TopOfBook top = cell.read();
+    if (top.sequence == 0)
+      continue;
+    auto i = static_cast<uint32_t>(top.bid_price);
+    consistent &= top.sequence >= last_sequence && top.sequence == i &&
+                  top.ask_price == int64_t{i} + 1 &&
+                  top.last_trade_price == int64_t{i} * 2 &&
+                  top.bid_qty == i && top.ask_qty == ~i;
+    last_sequence = top.sequence;
+  }
+  writer.join();
+  REQUIRE(consistent);
+  REQUIRE_EQ(cell.read().sequence, static_cast<uint64_t>(UPDATES));
+}
+
+TEST_CASE(DepthCache_keeps_the_best_levels_across_the_ring_wrap) {
+  MemoryArena arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  LockFreeRingBuffer<LevelDelta> ring(arena);
+  std::atomic<uint64_t> drops{0};
+  MarketDataSink feed(ring, drops);
+  InstrumentDirectory dir;
+  dir.set_market_data_sink(&feed);
+  dir.add_instrument(6);
+  const DepthCacheCell *cell = dir.depth_cache(6);
+  REQUIRE(cell != nullptr);
+  REQUIRE(dir.depth_cache(7) == nullptr);
+
+  uint64_t next_id = 1;
+  auto add = [&](int64_t tick, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->instrument_id = 6;
+    o->price = tick * config::DEFAULT_TICK_SIZE;
+    o->remaining_qty = qty;
+    o->side = side;
+    REQUIRE(dir.find(6)->add_order(o));
+  };
+
+  // The window starts at tick 97952 (slot 3744): its ring slots wrap from
+  // 4095 back to 0 at tick 98304
+  add(100'000, 1, Side::ASK);
+  dir.flush_market_data();
+  REQUIRE_EQ(cell->read().sequence, static_cast<uint64_t>(1));
+
+  // Twelve bid levels straddling the wrap in one message: one update
+  for (int64_t i = 0; i < 12; ++i)
+    add(98'306 - i, static_cast<uint32_t>(i + 1), Side::BID);
+  dir.flush_market_data();
+  ConflatedDepth depth = cell->read();
+  REQUIRE_EQ(depth.sequence, static_cast<uint64_t>(2));
+  REQUIRE_EQ(depth.feed_sequence, feed.sequence());
+  for (std::size_t i = 0; i < config::CONFLATED_DEPTH; ++i) {
+    REQUIRE_EQ(depth.bids[i].price,
+               (98'306 - static_cast<int64_t>(i)) * config::DEFAULT_TICK_SIZE);
+    REQUIRE_EQ(depth.bids[i].qty, static_cast<uint32_t>(i + 1));
+  }
+  REQUIRE_EQ(depth.asks[0].price, static_cast<int64_t>(1'000'000));
+  REQUIRE_EQ(depth.asks[1].price, static_cast<int64_t>(0));
+
+  // A change below the cached depth leaves the cell alone
+  add(98'200, 5, Side::BID);
+  dir.flush_market_data();
+  REQUIRE_EQ(cell->read().sequence, static_cast<uint64_t>(2));
+
+  // Asks walking up through the same wrap, on a second instrument
+  dir.add_instrument(7);
+  const DepthCacheCell *asks = dir.depth_cache(7);
+  auto add_ask = [&](int64_t tick) {
+    Order *o = pool.acquire();
+    o->id = next_id++;
+    o->instrument_id = 7;
+    o->price = tick * config::DEFAULT_TICK_SIZE;
+    o->remaining_qty = 3;
+    o->side = Side::ASK;
+    REQUIRE(dir.find(7)->add_order(o));
+  };
+  add_ask(97'960);
+  for (int64_t tick = 98'300; tick < 98'310; ++tick)
+    add_ask(tick);
+  dir.flush_market_data();
+  depth = asks->read();
+  REQUIRE_EQ(depth.asks[0].price, static_cast<int64_t>(979'600));
+  for (std::size_t i = 1; i < config::CONFLATED_DEPTH; ++i)
+    REQUIRE_EQ(depth.asks[i].price,
+               (98'299 + static_cast<int64_t>(i)) * config::DEFAULT_TICK_SIZE);
+}
+
+TEST_CASE(DepthCache_slow_reader_sees_whole_images_and_counts_the_rest) {
+  constexpr uint32_t UPDATES = 100'000;
+  DepthCacheCell cell;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    ConflatedDepth depth;
+    for (uint32_t i = 1; i <= UPDATES; ++i) {
+      for (std::size_t l = 0; l < config::CONFLATED_DEPTH; ++l) {
+        depth.bids[l] = {int64_t{i} - static_cast<int64_t>(l), i};
+        depth.asks[l] = {int64_t{i} + static_cast<int64_t>(l), ~i};
+      }
+      depth.feed_sequence = i;
+      cell.publish(depth);
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  // Reads only now and then: never blocks the writer, never gets a backlog
+  uint64_t last_sequence = 0;
+  uint64_t seen = 0;
+  uint64_t conflated = 0;
+  bool consistent = true;
+  for (bool finished = false; !finished;) {
+    finished = done.load(std::memory_order_acquire);
+    ConflatedDepth depth = cell.read();
+    if (depth.sequence != last_sequence) {
+      auto i = static_cast<uint32_t>(depth.feed_sequence);
+      consistent &= depth.sequence > last_sequence && depth.sequence == i;
+      for (std::size_t l = 0; l < config::CONFLATED_DEPTH; ++l)
+        consistent &=
+            depth.bids[l].price == int64_t{i} - static_cast<int64_t>(l) &&
+            depth.bids[l].qty == i &&
+            depth.asks[l].price == int64_t{i} + static_cast<int64_t>(l) &&
+            depth.asks[l].qty == ~i;
+      ++seen;
+      conflated += depth.sequence - last_sequence - 1;
+      last_sequence = depth.sequence;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+  writer.join();
+  REQUIRE(consistent);
+  REQUIRE_EQ(last_sequence, static_cast<uint64_t>(UPDATES));
+  REQUIRE_EQ(seen + conflated, static_cast<uint64_t>(UPDATES));
+}
+
+TEST_CASE(Snapshot_images_full_depth_across_the_ring_wrap) {
+  MemoryArena arena(16 * 1024 * 1024);
+  ObjectPool<Order> pool(arena, 100);
+  LockFreeRingBuffer<LevelDelta> ring(arena);
+  std::atomic<uint64_t> drops{0};
+  MarketDataSink feed(ring, drops);
+  InstrumentDirectory dir;
+  dir.set_market_data_sink(&feed);
+  dir.add_instrument(2);
+  auto snap = std::make_unique<BookSnapshot>();
+  REQUIRE(!dir.snapshot(3, *snap));
+  REQUIRE(dir.snapshot(2, *snap));
+  REQUIRE_EQ(snap->bids.levels, static_cast<std::size_t>(0));
+  REQUIRE_EQ(snap->asks.levels, static_cast<std::size_t>(0));
+
+  auto submit = [&](uint64_t id, int64_t price, uint32_t qty, Side side) {
+    Order *o = pool.acquire();
+    o->id = id;
+    o->instrument_id = 2;
+    o->price = price;
+    o->remaining_qty = qty;
+    o->side = side;
+    uint64_t filled = dir.submit_limit(*dir.find(2), o);
+    dir.flush_market_data();
+    return filled;
+  };
+
+  // The default window starts at ring slot 3744: ticks from 98304 up wrap
+  // to slot 0, so these two bids sit on both sides of the ring's end
+  submit(1, 983'000, 6, Side::BID);
+  submit(2, 983'100, 9, Side::BID);
+  submit(3, 983'100, 1, Side::BID);
+  submit(4, 1'000'000, 4, Side::ASK);
+  submit(5, 1'000'020, 8, Side::ASK);
+  REQUIRE(dir.snapshot(2, *snap));
+  REQUIRE_EQ(snap->sequence, feed.sequence());
+  REQUIRE_EQ(snap->tick_size, static_cast<int64_t>(10));
+  REQUIRE_EQ(snap->bids.first_price, static_cast<int64_t>(983'000));
+  REQUIRE_EQ(snap->bids.levels, static_cast<std::size_t>(11));
+  REQUIRE_EQ(snap->bids.qty[0], static_cast<uint32_t>(6));
+  for (std::size_t i = 1; i < 10; ++i)
+    REQUIRE_EQ(snap->bids.qty[i], static_cast<uint32_t>(0));
+  REQUIRE_EQ(snap->bids.qty[10], static_cast<uint32_t>(10));
+  REQUIRE_EQ(snap->asks.first_price, static_cast<int64_t>(1'000'000));
+  REQUIRE_EQ(snap->asks.levels, static_cast<std::size_t>(3));
+  REQUIRE_EQ(snap->asks.qty[0], static_cast<uint32_t>(4));
+  REQUIRE_EQ(snap->asks.qty[1], static_cast<uint32_t>(0));
+  REQUIRE_EQ(snap->asks.qty[2], static_cast<uint32_t>(8));
+
+  // Fills and cancels reach the image through the same hook as L2 deltas
+  REQUIRE_EQ(submit(6, 1'000'000, 4, Side::BID), static_cast<uint64_t>(4));
+  REQUIRE(dir.cancel_order(1));
+  dir.flush_market_data();
+  REQUIRE(dir.snapshot(2, *snap));
+  REQUIRE_EQ(snap->bids.first_price, static_cast<int64_t>(983'100));
+  REQUIRE_EQ(snap->bids.levels, static_cast<std::size_t>(1));
+  REQUIRE_EQ(snap->asks.first_price, static_cast<int64_t>(1'000'020));
+  REQUIRE_EQ(snap->asks.levels, static_cast<std::size_t>(1));
+  REQUIRE_EQ(snap->asks.qty[0], static_cast<uint32_t>(8));
+  REQUIRE_EQ(snap->sequence, feed.sequence());
+}
+
 // ═══════════════════════════════════════════════════════════════════════
 //  Main — Run all tests
 // ═══════════════════════════════════════════════════════════════════════